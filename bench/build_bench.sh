@@ -0,0 +1,20 @@
+#!/bin/bash
+# Build the mkfw benchmarks (Linux/X11 only).
+#
+# Output binaries land alongside their .c sources in this directory.
+# They need an X server; for repeatable numbers run them under Xvfb,
+# e.g. `xvfb-run -a ./pump`.
+
+set -e
+cd "$(dirname "$0")"
+
+CFLAGS="-std=gnu99 -O2 -Wall -Wextra"
+LDFLAGS="-lm -lpthread -ldl"
+
+for src in pump.c startup.c xthreads.c windows.c; do
+	name="${src%.c}"
+	echo "Building $name..."
+	gcc $CFLAGS "$src" $LDFLAGS -o "$name"
+done
+
+echo "Done."
@@ -0,0 +1,102 @@
+// Copyright (c) 2025-2026 Peter Fors
+// SPDX-License-Identifier: MIT
+//
+// Startup cost benchmark (Linux/X11).  Times mkfw_init, the fbconfig
+// attribute fetch against scoring the cached table, and GL window
+// creation: the first window pays for the GL version probe and the
+// fbconfig fetch, later ones only filter and score.  Prints wall time
+// and synchronous round trips for each phase, then the per-phase
+// breakdown mkfw keeps in ctx->stats.startup.
+//
+// Run under Xvfb for numbers that do not depend on the desktop:
+//   xvfb-run -a ./startup
+//
+// Build: ./build_bench.sh
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../mkfw.h"
+
+#define BENCH_WINDOWS 8
+#define BENCH_ROUNDS  20
+
+// [=]===^=[ on_error ]==========================================================================^===[=]
+static void on_error(const char *message) {
+	fprintf(stderr, "startup: mkfw_error: %s\n", message);
+}
+
+// [=]===^=[ report ]============================================================================^===[=]
+static void report(const char *name, uint64_t ns, uint32_t count, uint64_t round_trips) {
+	printf("%-20s %10.3f ms  %6.1f round trips\n", name, (double)ns / 1e6 / count, (double)round_trips / count);
+}
+
+// [=]===^=[ main ]==============================================================================^===[=]
+int main(void) {
+	mkfw_set_error_callback(on_error);
+
+	uint64_t start = mkfw_get_time();
+	struct mkfw_context *ctx = mkfw_init(0);
+	if(!ctx) {
+		return 1;
+	}
+	report("mkfw_init", mkfw_get_time() - start, 1, ctx->stats.round_trips);
+
+	// Uncached: what every window paid before the table was kept.
+	Display *dpy = CTX_PLATFORM(ctx)->display;
+	uint32_t count = 0;
+	start = mkfw_get_time();
+	for(uint32_t i = 0; i < BENCH_ROUNDS; ++i) {
+		free(x11_fbconfig_table_build(dpy, DefaultScreen(dpy), &count));
+	}
+	report("fbconfig fetch", mkfw_get_time() - start, BENCH_ROUNDS, 0);
+	printf("%-20s %10u\n", "fbconfigs", count);
+
+	// Cached: filter and score only.
+	struct x11_fbconfig *table = x11_context_fbconfigs(ctx, &count);
+	start = mkfw_get_time();
+	for(uint32_t i = 0; i < BENCH_ROUNDS; ++i) {
+		select_best_fbconfig_for(dpy, table, count, 0, 24, 8, 0, 0);
+	}
+	report("fbconfig score", mkfw_get_time() - start, BENCH_ROUNDS, 0);
+
+	struct mkfw_window_options opts = {
+		.width = 320, .height = 240, .title = "mkfw startup bench",
+		.graphics_api = MKFW_GFX_GL, .flags = MKFW_WIN_HIDDEN,
+	};
+	struct mkfw_window *windows[BENCH_WINDOWS];
+	uint64_t rt = ctx->stats.round_trips;
+	start = mkfw_get_time();
+	windows[0] = mkfw_window_create(ctx, &opts);
+	if(!windows[0]) {
+		mkfw_shutdown(ctx);
+		return 1;
+	}
+	report("first GL window", mkfw_get_time() - start, 1, ctx->stats.round_trips - rt);
+
+	rt = ctx->stats.round_trips;
+	start = mkfw_get_time();
+	for(uint32_t i = 1; i < BENCH_WINDOWS; ++i) {
+		windows[i] = mkfw_window_create(ctx, &opts);
+		if(!windows[i]) {
+			mkfw_shutdown(ctx);
+			return 1;
+		}
+	}
+	report("next GL windows", mkfw_get_time() - start, BENCH_WINDOWS - 1, ctx->stats.round_trips - rt);
+
+	mkfw_poll_events(ctx);	// publishes deferred_libs_ns if the loader is done
+	struct mkfw_startup_stats *st = &ctx->stats.startup;
+	printf("\nstartup breakdown\n");
+	printf("%-20s %10.3f ms\n", "init", (double)st->init_ns / 1e6);
+	printf("%-20s %10.3f ms\n", "  libraries", (double)st->libs_ns / 1e6);
+	printf("%-20s %10.3f ms\n", "  display", (double)st->display_ns / 1e6);
+	printf("%-20s %10.3f ms\n", "  atoms", (double)st->atoms_ns / 1e6);
+	printf("%-20s %10.3f ms\n", "  input", (double)st->input_ns / 1e6);
+	printf("%-20s %10.3f ms\n", "  monitors", (double)st->monitors_ns / 1e6);
+	printf("%-20s %10.3f ms\n", "deferred libraries", (double)st->deferred_libs_ns / 1e6);
+	printf("%-20s %10.3f ms\n", "first window", (double)st->first_window_ns / 1e6);
+
+	mkfw_shutdown(ctx);
+	return 0;
+}
@@ -0,0 +1,123 @@
+// Copyright (c) 2025-2026 Peter Fors
+// SPDX-License-Identifier: MIT
+//
+// Window registry scaling benchmark (Linux/X11).  Grows a context from 1
+// to 500 hidden windows and, at each step, times an idle
+// mkfw_poll_events, the routing of a burst of synthetic MotionNotify
+// events to the newest window, and window creation.  Then destroys them
+// all, oldest first.  Every column should stay flat as the window count
+// grows; destroy grows only by a pointer shift per remaining window.
+//
+// Run under Xvfb for numbers that do not depend on the desktop:
+//   xvfb-run -a ./windows
+//
+// Build: ./build_bench.sh
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../mkfw.h"
+
+#define BENCH_IDLE_PUMPS  2000
+#define BENCH_BATCH       5000
+
+static const uint32_t steps[] = { 1, 10, 50, 100, 250, 500 };
+
+static uint64_t motion_events;
+
+// [=]===^=[ on_error ]==========================================================================^===[=]
+static void on_error(const char *message) {
+	fprintf(stderr, "windows: mkfw_error: %s\n", message);
+}
+
+// [=]===^=[ on_cursor_pos ]=====================================================================^===[=]
+static void on_cursor_pos(struct mkfw_window *window, int32_t x, int32_t y) {
+	(void)window;
+	(void)x;
+	(void)y;
+	++motion_events;
+}
+
+// [=]===^=[ flood ]=============================================================================^===[=]
+static void flood(Display *sender, Window target, uint32_t count) {
+	XEvent ev = {0};
+	ev.xmotion.type = MotionNotify;
+	ev.xmotion.window = target;
+	ev.xmotion.same_screen = True;
+	for(uint32_t i = 0; i < count; ++i) {
+		ev.xmotion.x = (int)(i & 511);
+		ev.xmotion.y = (int)((i >> 9) & 511);
+		XSendEvent(sender, target, False, PointerMotionMask, &ev);
+	}
+	XSync(sender, False);
+}
+
+// [=]===^=[ main ]==============================================================================^===[=]
+int main(void) {
+	mkfw_set_error_callback(on_error);
+
+	struct mkfw_context *ctx = mkfw_init(0);
+	if(!ctx) {
+		return 1;
+	}
+
+	Display *sender = XOpenDisplay(0);
+	if(!sender) {
+		fprintf(stderr, "windows: unable to open sender display\n");
+		mkfw_shutdown(ctx);
+		return 1;
+	}
+
+	struct mkfw_window_options opts = {
+		.width = 64, .height = 64, .title = "mkfw windows bench",
+		.graphics_api = MKFW_GFX_NONE, .flags = MKFW_WIN_HIDDEN,
+	};
+
+	printf("%8s %12s %14s %14s\n", "windows", "create us", "idle pump ns", "route ns/evt");
+	uint32_t created = 0;
+	for(uint32_t s = 0; s < sizeof(steps) / sizeof(steps[0]); ++s) {
+		uint32_t added = steps[s] - created;
+		uint64_t start = mkfw_get_time();
+		struct mkfw_window *target = 0;
+		for(; created < steps[s]; ++created) {
+			target = mkfw_window_create(ctx, &opts);
+			if(!target) {
+				XCloseDisplay(sender);
+				mkfw_shutdown(ctx);
+				return 1;
+			}
+			mkfw_window_set_cursor_pos_callback(target, on_cursor_pos);
+		}
+		uint64_t create_ns = mkfw_get_time() - start;
+		mkfw_poll_events(ctx);   // settle creation-time events
+
+		start = mkfw_get_time();
+		for(uint32_t i = 0; i < BENCH_IDLE_PUMPS; ++i) {
+			mkfw_poll_events(ctx);
+		}
+		uint64_t idle_ns = mkfw_get_time() - start;
+
+		// A hidden window never sees EnterNotify; mark it by hand.
+		PLATFORM(target)->in_window = 1;
+		uint64_t expected = motion_events + BENCH_BATCH;
+		flood(sender, PLATFORM(target)->window, BENCH_BATCH);
+		start = mkfw_get_time();
+		while(motion_events < expected) {
+			mkfw_poll_events(ctx);
+		}
+		uint64_t route_ns = mkfw_get_time() - start;
+
+		printf("%8u %12.1f %14.1f %14.1f\n", created, (double)create_ns / 1e3 / added, (double)idle_ns / BENCH_IDLE_PUMPS, (double)route_ns / BENCH_BATCH);
+	}
+
+	// Oldest first: the worst case, every destroy shifts all later windows.
+	uint64_t start = mkfw_get_time();
+	while(ctx->window_count > 0) {
+		mkfw_window_destroy(ctx->windows[0]);
+	}
+	printf("destroy  %10.1f us/window\n", (double)(mkfw_get_time() - start) / 1e3 / created);
+
+	XCloseDisplay(sender);
+	mkfw_shutdown(ctx);
+	return 0;
+}
@@ -0,0 +1,136 @@
+// Copyright (c) 2025-2026 Peter Fors
+// SPDX-License-Identifier: MIT
+//
+// Display-lock cost benchmark (Linux/X11).  Measures mkfw_poll_events
+// throughput on a flood of synthetic MotionNotify events, and the cost
+// of a cheap setter in a tight loop, once with XInitThreads and once
+// with MKFW_INIT_NO_X_THREADS.  XInitThreads cannot be undone within a
+// process, so each mode runs in its own forked child before any Xlib
+// call is made.
+//
+// libX11 1.8 and later enable thread support by themselves; there the
+// two runs should match.
+//
+// Run under Xvfb for numbers that do not depend on the desktop:
+//   xvfb-run -a ./xthreads
+//
+// Build: ./build_bench.sh
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../mkfw.h"
+
+#define BENCH_ROUNDS  20
+#define BENCH_BATCH   10000
+#define BENCH_SETTERS 200000
+
+static uint64_t motion_events;
+
+// [=]===^=[ on_error ]==========================================================================^===[=]
+static void on_error(const char *message) {
+	fprintf(stderr, "xthreads: mkfw_error: %s\n", message);
+}
+
+// [=]===^=[ on_cursor_pos ]=====================================================================^===[=]
+static void on_cursor_pos(struct mkfw_window *window, int32_t x, int32_t y) {
+	(void)window;
+	(void)x;
+	(void)y;
+	++motion_events;
+}
+
+// [=]===^=[ flood ]=============================================================================^===[=]
+static void flood(Display *sender, Window target, uint32_t count) {
+	XEvent ev = {0};
+	ev.xmotion.type = MotionNotify;
+	ev.xmotion.window = target;
+	ev.xmotion.same_screen = True;
+	for(uint32_t i = 0; i < count; ++i) {
+		ev.xmotion.x = (int)(i & 511);
+		ev.xmotion.y = (int)((i >> 9) & 511);
+		XSendEvent(sender, target, False, PointerMotionMask, &ev);
+	}
+	XSync(sender, False);
+}
+
+// [=]===^=[ run ]===============================================================================^===[=]
+static int run(const char *name, uint32_t flags) {
+	mkfw_set_error_callback(on_error);
+
+	struct mkfw_options options = { .version = MKFW_OPTIONS_VERSION, .flags = flags };
+	struct mkfw_context *ctx = mkfw_init(&options);
+	if(!ctx) {
+		return 1;
+	}
+
+	struct mkfw_window_options opts = {
+		.width = 320, .height = 240, .title = "mkfw xthreads bench",
+		.graphics_api = MKFW_GFX_NONE, .flags = MKFW_WIN_HIDDEN,
+	};
+	struct mkfw_window *target = mkfw_window_create(ctx, &opts);
+	if(!target) {
+		mkfw_shutdown(ctx);
+		return 1;
+	}
+	mkfw_window_set_cursor_pos_callback(target, on_cursor_pos);
+
+	Display *sender = XOpenDisplay(0);
+	if(!sender) {
+		fprintf(stderr, "xthreads: unable to open sender display\n");
+		mkfw_shutdown(ctx);
+		return 1;
+	}
+
+	mkfw_poll_events(ctx);   // settle creation-time events
+	PLATFORM(target)->in_window = 1;
+
+	uint64_t drain_ns = 0;
+	for(uint32_t round = 0; round < BENCH_ROUNDS; ++round) {
+		uint64_t expected = motion_events + BENCH_BATCH;
+		flood(sender, PLATFORM(target)->window, BENCH_BATCH);
+		uint64_t start = mkfw_get_time();
+		while(motion_events < expected) {
+			mkfw_poll_events(ctx);
+		}
+		drain_ns += mkfw_get_time() - start;
+	}
+
+	// XMoveWindow only queues a request: the cost is Xlib and its lock.
+	uint64_t start = mkfw_get_time();
+	for(uint32_t i = 0; i < BENCH_SETTERS; ++i) {
+		mkfw_window_set_position(target, (int32_t)(i & 63), 0);
+	}
+	uint64_t setter_ns = mkfw_get_time() - start;
+
+	printf("%-12s %12.0f events/s  %8.1f ns/setter\n", name, (double)motion_events / ((double)drain_ns / 1e9), (double)setter_ns / BENCH_SETTERS);
+
+	XCloseDisplay(sender);
+	mkfw_shutdown(ctx);
+	return 0;
+}
+
+// [=]===^=[ run_forked ]========================================================================^===[=]
+static int run_forked(const char *name, uint32_t flags) {
+	fflush(stdout);
+	pid_t pid = fork();
+	if(pid < 0) {
+		perror("xthreads: fork");
+		return 1;
+	}
+	if(pid == 0) {
+		_exit(run(name, flags));
+	}
+	int status = 0;
+	waitpid(pid, &status, 0);
+	return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+// [=]===^=[ main ]==============================================================================^===[=]
+int main(void) {
+	int result = run_forked("locked", 0);
+	result |= run_forked("no-threads", MKFW_INIT_NO_X_THREADS);
+	return result;
+}
@@ -3,8 +3,9 @@
 //
 // Multi-window example: opens two windows on a single mkfw_context,
 // pumps events for both from a single mkfw_poll_events() call, and
-// renders an independent solid color into each window.  Closing
-// either window terminates the application.
+// renders an independent solid color into each window, then presents
+// both with one mkfw_present_windows() call so they share one vblank
+// wait.  Closing either window terminates the application.
 
 #include <stdio.h>
 
@@ -16,7 +17,6 @@ static void render(struct mkfw_window *w, float r, float g, float b) {
 	mkfw_window_attach_context(w);
 	glClearColor(r, g, b, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT);
-	mkfw_window_swap_buffers(w);
 }
 
 // [=]===^=[ on_error ]==========================================================================^===[=]
@@ -48,6 +48,9 @@ int main(void) {
 
 	mkfw_gl_loader();
 
+	// The last window in the list is the one that waits for vblank.
+	struct mkfw_window *present[] = { debug_w, main_w };
+
 	while(!mkfw_window_should_close(main_w) && !mkfw_window_should_close(debug_w)) {
 		mkfw_poll_events(ctx);   // one pump, both windows
 
@@ -57,6 +60,7 @@ int main(void) {
 
 		render(main_w,  0.15f, 0.15f, 0.20f);
 		render(debug_w, 0.40f, 0.10f, 0.10f);
+		mkfw_present_windows(ctx, present, 2);
 
 		mkfw_window_update_input_state(main_w);
 		mkfw_window_update_input_state(debug_w);
@@ -74,6 +74,17 @@ typedef void (*mkfw_content_scale_callback_t)(struct mkfw_window *window, float
 typedef void (*mkfw_cursor_enter_callback_t)(struct mkfw_window *window, uint8_t entered);
 typedef void (*mkfw_cursor_pos_callback_t)(struct mkfw_window *window, int32_t x, int32_t y);
 
+/* Timestamped variants of the input callbacks.  time is when the input
+ * happened, in nanoseconds on the mkfw_get_time() clock: on Linux the
+ * X server's event timestamp (millisecond resolution), calibrated once
+ * against CLOCK_MONOTONIC; on Win32 the moment mkfw dispatched the
+ * message.  Installed alongside, not instead of, the plain callbacks. */
+typedef void (*mkfw_key_timed_callback_t)(struct mkfw_window *window, uint32_t key, uint32_t action, uint32_t modifier_bits, uint64_t time);
+typedef void (*mkfw_mouse_button_timed_callback_t)(struct mkfw_window *window, uint8_t button, uint32_t action, uint64_t time);
+typedef void (*mkfw_cursor_pos_timed_callback_t)(struct mkfw_window *window, int32_t x, int32_t y, uint64_t time);
+typedef void (*mkfw_mouse_move_delta_timed_callback_t)(struct mkfw_window *window, int32_t x, int32_t y, uint64_t time);
+typedef void (*mkfw_scroll_timed_callback_t)(struct mkfw_window *window, double xoffset, double yoffset, uint64_t time);
+
 /* Fired when the window manager asks the window to close (Linux
  * WM_DELETE_WINDOW, Win32 WM_CLOSE).  mkfw has already set the
  * should-close flag; veto the close by calling
@@ -90,6 +101,7 @@ typedef void (*mkfw_monitor_callback_t)(struct mkfw_context *ctx);
  * mkfw_window_create and destroy with mkfw_window_destroy. */
 struct mkfw_window {
 	struct mkfw_context *context;
+	uint32_t context_index;   // internal: slot in context->windows[] while live
 
 	// Input state
 	uint8_t keyboard_state[MKFW_KEY_LAST];
@@ -121,6 +133,13 @@ struct mkfw_window {
 	mkfw_cursor_pos_callback_t cursor_pos_callback;
 	mkfw_close_callback_t close_callback;
 
+	// Timestamped input callbacks
+	mkfw_key_timed_callback_t key_timed_callback;
+	mkfw_mouse_button_timed_callback_t mouse_button_timed_callback;
+	mkfw_cursor_pos_timed_callback_t cursor_pos_timed_callback;
+	mkfw_mouse_move_delta_timed_callback_t mouse_move_delta_timed_callback;
+	mkfw_scroll_timed_callback_t scroll_timed_callback;
+
 	// Platform-specific state
 	void *platform;
 
@@ -209,27 +228,200 @@ struct mkfw_video_mode {
 	int32_t refresh_rate;
 };
 
+/* Fixed-capacity single-producer / single-consumer ring of mkfw_event
+ * records.  head is written only by the producer, tail only by the
+ * consumer; events is 0 when the ring is not in use. */
+struct mkfw_event_ring {
+	struct mkfw_event *events;
+	uint32_t mask;
+	uint32_t head;
+	uint32_t tail;
+	uint32_t dropped;   // records discarded because the ring was full
+};
+
+/* Where mkfw_init and the first window spent their time, in
+ * nanoseconds.  Phases that do not apply to the platform, or whose
+ * libraries an earlier context already loaded, stay 0.
+ * deferred_libs_ns is measured on the loader thread and copied here
+ * by the first mkfw_poll_events or mkfw_window_create after the thread
+ * has finished; until then it reads 0. */
+struct mkfw_startup_stats {
+	uint64_t init_ns;            // all of mkfw_init
+	uint64_t libs_ns;            // mkfw_init loading or waiting for libX11, libXrandr, libXi
+	uint64_t display_ns;         // opening the display connection
+	uint64_t atoms_ns;           // resource database and atom interning
+	uint64_t input_ns;           // server clock, keymap, XInput2, auto-repeat
+	uint64_t monitors_ns;        // XRandR setup and the monitor cache
+	uint64_t deferred_libs_ns;   // libGL and libXcursor, loaded off the main thread
+	uint64_t first_window_ns;    // first mkfw_window_create, including any wait for libGL
+};
+
+/* Instrumentation counters kept by mkfw and read by the caller.  A
+ * "round trip" is a request that blocks until the display server
+ * replies (XSync, XGetWindowProperty, XQueryPointer, ...); always 0 on
+ * Windows. */
+struct mkfw_stats {
+	uint64_t round_trips;             // since mkfw_init
+	uint32_t round_trips_last_frame;  // between the last two mkfw_poll_events calls
+	uint64_t round_trips_frame_mark;  // internal: round_trips at the last pump
+	struct mkfw_startup_stats startup;
+};
+
+/* Where the present timing of a window comes from; see
+ * mkfw_window_get_present_stats. */
+#define MKFW_PRESENT_CPU   0   // time mkfw_window_swap_buffers returned
+#define MKFW_PRESENT_OML   1   // GLX_OML_sync_control, sampled when queried
+#define MKFW_PRESENT_INTEL 2   // GLX_INTEL_swap_event, one record per completed swap
+
+/* Presentation timing of one GL window.  Times are nanoseconds on the
+ * mkfw_get_time clock. */
+struct mkfw_present_stats {
+	uint32_t source;          // MKFW_PRESENT_*
+	uint32_t queue_depth;     // swaps issued but not yet on screen
+	uint64_t swaps;           // mkfw_window_swap_buffers calls
+	uint64_t sbc;             // swaps on screen (swap buffer count)
+	uint64_t msc;             // vblank counter at the last sample; 0 with MKFW_PRESENT_CPU
+	uint64_t ust_ns;          // time of the last sample
+	uint64_t submit_ns;       // when mkfw_window_swap_buffers was last called
+	uint64_t refresh_ns;      // measured refresh period, smoothed; 0 until known
+	uint64_t missed_vblanks;  // vblanks that passed without a new frame
+};
+
 /* Library-level handle.  Created with mkfw_init, destroyed with
  * mkfw_shutdown.  Owns the platform display connection, loaded
  * function pointers, monitor cache, shared atoms, shared cursor
  * handles, and all windows created against it. */
-#define MKFW_MAX_WINDOWS 16
+#define MKFW_MAX_WINDOWS 16   // deprecated: windows[] has no limit; kept for source compatibility
+#define MKFW_MAX_POOLED_WINDOWS 16
 
 struct mkfw_context {
 	void *platform;
 
-	struct mkfw_window *windows[MKFW_MAX_WINDOWS];
+	// Live windows in creation order, grown as needed.
+	struct mkfw_window **windows;
 	uint32_t window_count;
+	uint32_t window_capacity;
+
+	// Hidden, fully created windows waiting to be handed out by
+	// mkfw_window_create; not in windows[].  See mkfw_window_pool_fill.
+	struct mkfw_window *pool[MKFW_MAX_POOLED_WINDOWS];
+	uint32_t pool_count;
+
+	// mkfw_window_create_async requests not yet created, oldest first.
+	struct mkfw_window_request *window_requests;
+	uint32_t window_request_count;
 
 	struct mkfw_monitor monitors[MKFW_MAX_MONITORS];
 	uint32_t monitor_count;
 
 	mkfw_monitor_callback_t monitor_callback;
+
+	uint32_t flags;               // MKFW_INIT_* given to mkfw_init
+
+	// mkfw_poll_events stops early once either budget is spent and leaves
+	// the rest queued for the next pump; 0 = unlimited.  See
+	// mkfw_set_pump_budget.
+	uint32_t pump_budget_events;
+	uint64_t pump_budget_ns;
+
+	// Queued input (MKFW_INIT_EVENT_QUEUE), produced by the pump.
+	struct mkfw_event_ring event_queue;
+
+	// Raw device input (MKFW_INIT_INPUT_THREAD), produced by the input thread.
+	struct mkfw_event_ring raw_input;
+
+	struct mkfw_stats stats;
 };
 
-/* Library init options.  Pass 0 to use defaults for every field. */
+/* Library init flags (mkfw_options.flags) */
+#define MKFW_INIT_EVENT_QUEUE  (1u << 0)  // deliver input through mkfw_next_event instead of callbacks
+#define MKFW_INIT_INPUT_THREAD (1u << 1)  // read raw pointer input on an mkfw-owned thread (Linux)
+#define MKFW_INIT_COALESCE_MOTION (1u << 2)  // merge raw mouse deltas into one per window per pump
+#define MKFW_INIT_NO_X_THREADS (1u << 3)  // skip XInitThreads; only the owning thread makes X calls (Linux)
+
+/* Library init options.  Pass 0 to use defaults for every field.
+ *
+ * MKFW_INIT_EVENT_QUEUE replaces the input callbacks with a fixed-size
+ * single-producer / single-consumer ring on the context.  The pump
+ * writes one mkfw_event record per key, char, button, motion, raw
+ * delta, scroll, enter/leave, focus, resize and close request, and
+ * never calls those callbacks; any one thread drains the ring with
+ * mkfw_next_event.  event_queue_capacity is rounded up to a power of
+ * two; when the ring is full new records are dropped and counted in
+ * mkfw_context.event_queue.dropped.
+ *
+ * MKFW_INIT_INPUT_THREAD starts a thread with its own display
+ * connection that reads raw pointer motion and buttons for the whole
+ * seat, independent of the pump and of window focus.  Motion read in
+ * one wakeup is coalesced into a single delta; buttons and wheel steps
+ * are kept in order.  Read the stream with mkfw_next_raw_event.  Linux
+ * only; ignored on Windows.
+ *
+ * MKFW_INIT_COALESCE_MOTION sums the raw mouse deltas a pump reads for
+ * a window and reports them as one mouse-delta event, emitted before
+ * the window's next key / button event or at the end of the pump.  The
+ * total is preserved: fractions carry into the next delta.
+ *
+ * MKFW_INIT_NO_X_THREADS declares that no thread but the one calling
+ * mkfw_init touches X, so mkfw skips XInitThreads and Xlib takes no
+ * display lock around each call.  XInitThreads is process-wide: once
+ * any context (or other code) enables it, it stays on, and libX11 1.8
+ * and later enable it by themselves.  Ignored with
+ * MKFW_INIT_INPUT_THREAD, whose thread needs the locking.  Build with
+ * MKFW_DEBUG defined to have mkfw_error report the first mkfw X call
+ * made from another thread.  Linux only; ignored on Windows.
+ *
+ * pump_budget_events / pump_budget_ns bound the work one
+ * mkfw_poll_events call does; 0 = unlimited.
+ *
+ * version: the original struct held only version, so every other field
+ * is read only with version >= 1; a caller built against that header is
+ * never read past its end.  Set it to MKFW_OPTIONS_VERSION. */
+#define MKFW_OPTIONS_VERSION 1   // 1: flags through gl_version_cache
+
 struct mkfw_options {
-	uint32_t version;        // 0 = current
+	uint32_t version;              // MKFW_OPTIONS_VERSION; 0 = defaults for everything
+	uint32_t flags;                // MKFW_INIT_*
+	uint32_t event_queue_capacity; // records; 0 = 1024
+	uint32_t raw_input_capacity;   // records; 0 = 1024
+	uint32_t pump_budget_events;   // events per mkfw_poll_events; 0 = unlimited
+	uint64_t pump_budget_ns;       // time per mkfw_poll_events; 0 = unlimited
+	const char *gl_version_cache;  // file caching the driver's max GL version (Linux); 0 = none
+};
+
+/* Queued input record (MKFW_INIT_EVENT_QUEUE).  The payload member
+ * matching type is valid.  time is in nanoseconds on the mkfw_get_time()
+ * clock.  window stays valid until that window is destroyed, so drain
+ * the queue before destroying windows.  Raw input records
+ * (mkfw_next_raw_event) are not tied to a window and have window == 0. */
+enum mkfw_event_type {
+	MKFW_EVENT_NONE = 0,
+	MKFW_EVENT_KEY,               // key
+	MKFW_EVENT_CHAR,              // character
+	MKFW_EVENT_MOUSE_BUTTON,      // button
+	MKFW_EVENT_CURSOR_POS,        // pos
+	MKFW_EVENT_CURSOR_ENTER,      // state: 1 = entered, 0 = left
+	MKFW_EVENT_MOUSE_DELTA,       // delta
+	MKFW_EVENT_SCROLL,            // scroll
+	MKFW_EVENT_FOCUS,             // state: 1 = focused, 0 = unfocused
+	MKFW_EVENT_FRAMEBUFFER_SIZE,  // size
+	MKFW_EVENT_CLOSE,             // no payload; should-close is already set
+};
+
+struct mkfw_event {
+	uint32_t type;                // MKFW_EVENT_*
+	struct mkfw_window *window;
+	uint64_t time;
+	union {
+		struct { uint32_t key; uint32_t action; uint32_t modifier_bits; } key;
+		struct { uint32_t codepoint; } character;
+		struct { uint32_t button; uint32_t action; } button;
+		struct { int32_t x; int32_t y; } pos;
+		struct { int32_t dx; int32_t dy; } delta;
+		struct { double x; double y; } scroll;
+		struct { int32_t width; int32_t height; } size;
+		uint8_t state;
+	};
 };
 
 /* Window-creation flags */
@@ -238,6 +430,8 @@ struct mkfw_options {
 #define MKFW_WIN_FLOATING     (1u << 2)  // always-on-top
 #define MKFW_WIN_MAXIMIZED    (1u << 3)  // start maximized
 #define MKFW_WIN_NO_FOCUS     (1u << 4)  // do not take input focus on create/show
+#define MKFW_WIN_RECYCLE      (1u << 5)  // mkfw_window_destroy returns the window to the pool
+#define MKFW_WIN_POLL_DELTA   (1u << 6)  // accumulate raw motion for mkfw_window_get_and_clear_mouse_delta from creation
 
 /* OpenGL context-creation flags (mkfw_window_options.context_flags).
  *
@@ -306,9 +500,23 @@ enum mkfw_gl_profile {
  *
  * share_window: pass another window created against the same context to
  * share GL objects (textures, buffers, ...) between the two contexts.
- * The two windows should use compatible pixel formats.  0 = no sharing. */
+ * The two windows should use compatible pixel formats.  0 = no sharing.
+ *
+ * frames_in_flight: with N > 0, mkfw_window_swap_buffers puts a GL fence
+ * behind every frame and waits for the one from N swaps back, so the
+ * driver never queues more than N frames ahead of the display.  Needs GL
+ * 3.2 or ARB_sync.  0 = leave queueing to the driver.  Change it later
+ * with mkfw_window_set_frames_in_flight.
+ *
+ * version: fields added after x11_class_name are only read when version
+ * is at least the value that introduced them, so a caller built against
+ * an older header, whose struct is shorter, is never read past its end.
+ * Set it to MKFW_WINDOW_OPTIONS_VERSION to use them. */
+#define MKFW_MAX_FRAMES_IN_FLIGHT 4
+#define MKFW_WINDOW_OPTIONS_VERSION 1   // 1: frames_in_flight
+
 struct mkfw_window_options {
-	uint32_t version;        // 0 = current
+	uint32_t version;        // MKFW_WINDOW_OPTIONS_VERSION; 0 = original layout
 	int32_t  width;          // 0 = 1280
 	int32_t  height;         // 0 = 720
 	const char *title;       // 0 = "mkfw"
@@ -324,6 +532,47 @@ struct mkfw_window_options {
 	uint32_t context_flags;  // MKFW_CONTEXT_*
 	struct mkfw_window *share_window; // 0 = no sharing
 	const char *x11_class_name; // X11 WM_CLASS instance/class name; 0 = "mkfw". Linux only.
+	uint32_t frames_in_flight; // version >= 1; 0 = driver's choice; 1..MKFW_MAX_FRAMES_IN_FLIGHT
+};
+
+/* Asynchronous window creation; see mkfw_window_create_async.  The
+ * request is caller-owned and, with the strings its options point to,
+ * must stay valid until ready is set. */
+struct mkfw_window_request;
+typedef void (*mkfw_window_ready_callback_t)(struct mkfw_window_request *req);
+
+struct mkfw_window_request {
+	mkfw_window_ready_callback_t callback;  // called from the pump once ready; 0 = poll ready
+	void *user_data;
+	struct mkfw_window *window;   // the new window once ready; 0 if creation failed
+	uint32_t ready;               // set by the pump when creation has finished
+
+	// Internal
+	struct mkfw_window_options options;
+	struct mkfw_window_request *next;
+};
+
+/* Swap-interval support of a window's GL context, from
+ * mkfw_window_get_swap_caps. */
+#define MKFW_SWAP_CAP_INTERVAL (1u << 0)  // mkfw_window_set_swap_interval takes effect
+#define MKFW_SWAP_CAP_TEAR     (1u << 1)  // negative intervals: late swaps tear instead of waiting a vblank
+
+/* Just-in-time frame pacing; see mkfw_window_pace_frame.  Caller-owned;
+ * zero-initialise one per window. */
+#define MKFW_PACER_HISTORY 16
+
+struct mkfw_frame_pacer {
+	uint64_t refresh_ns;   // 0 = measured, else the window's monitor, else 60 Hz
+	uint64_t margin_ns;    // slack left between the swap and the vblank; 0 = 1 ms
+
+	// Set by mkfw_window_pace_frame
+	uint64_t vblank_ns;    // vblank the frame about to be rendered is aimed at
+	uint64_t render_ns;    // expected render time: slowest of the last MKFW_PACER_HISTORY frames
+
+	// Internal
+	uint64_t wake_ns;      // when the last wait returned
+	uint64_t history[MKFW_PACER_HISTORY];   // wake-to-swap time of recent frames
+	uint32_t history_index;
 };
 
 /* Native platform handles for callers that need to integrate with
@@ -409,6 +658,13 @@ MKFW_API uint32_t             mkfw_query_max_gl_version(int32_t *major, int32_t
 MKFW_API void                 mkfw_poll_events(struct mkfw_context *ctx);
 MKFW_API void                 mkfw_wait_events(struct mkfw_context *ctx);
 MKFW_API void                 mkfw_wait_events_timeout(struct mkfw_context *ctx, uint64_t nanoseconds);
+MKFW_API uint32_t             mkfw_next_event(struct mkfw_context *ctx, struct mkfw_event *out);
+MKFW_API uint32_t             mkfw_next_raw_event(struct mkfw_context *ctx, struct mkfw_event *out);
+
+/* Batched window updates: setters called between the two send their
+ * requests in one flush at mkfw_commit_batch (X11).  Pairs nest. */
+MKFW_API void                 mkfw_begin_batch(struct mkfw_context *ctx);
+MKFW_API void                 mkfw_commit_batch(struct mkfw_context *ctx);
 
 /* Time */
 MKFW_API uint64_t             mkfw_get_time(void);
@@ -416,11 +672,14 @@ MKFW_API void                 mkfw_sleep(uint64_t nanoseconds);
 
 /* Window lifecycle */
 MKFW_API struct mkfw_window  *mkfw_window_create(struct mkfw_context *ctx, struct mkfw_window_options *opts);
+MKFW_API uint32_t             mkfw_window_create_async(struct mkfw_context *ctx, struct mkfw_window_options *opts, struct mkfw_window_request *req);
 MKFW_API void                 mkfw_window_destroy(struct mkfw_window *state);
 MKFW_API void                 mkfw_window_show(struct mkfw_window *state);
 MKFW_API void                 mkfw_window_hide(struct mkfw_window *state);
 MKFW_API uint32_t             mkfw_window_should_close(struct mkfw_window *state);
 MKFW_API void                 mkfw_window_set_should_close(struct mkfw_window *state, int32_t value);
+MKFW_API uint32_t             mkfw_window_pool_fill(struct mkfw_context *ctx, struct mkfw_window_options *opts, uint32_t count);
+MKFW_API void                 mkfw_window_pool_clear(struct mkfw_context *ctx);
 
 /* Window attributes */
 MKFW_API void                 mkfw_window_set_title(struct mkfw_window *state, const char *title);
@@ -448,8 +707,13 @@ MKFW_API float                mkfw_window_get_content_scale(struct mkfw_window *
 MKFW_API void                 mkfw_window_attach_context(struct mkfw_window *state);
 MKFW_API void                 mkfw_window_detach_context(struct mkfw_window *state);
 MKFW_API void                 mkfw_window_swap_buffers(struct mkfw_window *state);
-MKFW_API void                 mkfw_window_set_swap_interval(struct mkfw_window *state, uint32_t interval);
+MKFW_API void                 mkfw_present_windows(struct mkfw_context *ctx, struct mkfw_window **windows, uint32_t count);
+MKFW_API void                 mkfw_window_set_swap_interval(struct mkfw_window *state, int32_t interval);
 MKFW_API int32_t              mkfw_window_get_swap_interval(struct mkfw_window *state);
+MKFW_API uint32_t             mkfw_window_get_swap_caps(struct mkfw_window *state);
+MKFW_API void                 mkfw_window_set_frames_in_flight(struct mkfw_window *state, uint32_t frames);
+MKFW_API uint32_t             mkfw_window_get_present_stats(struct mkfw_window *state, struct mkfw_present_stats *out);
+MKFW_API uint64_t             mkfw_window_pace_frame(struct mkfw_window *state, struct mkfw_frame_pacer *pacer);
 
 /* Mouse + cursor */
 MKFW_API void                 mkfw_window_set_mouse_sensitivity(struct mkfw_window *state, double sensitivity);
@@ -469,6 +733,7 @@ MKFW_API void                 mkfw_window_set_custom_cursor(struct mkfw_window *
 MKFW_API void                 mkfw_window_set_clipboard_text(struct mkfw_window *state, const char *text);
 MKFW_API char                *mkfw_window_get_clipboard_text(struct mkfw_window *state);
 MKFW_API void                 mkfw_window_enable_drop(struct mkfw_window *state, uint8_t enable);
+MKFW_API void                 mkfw_window_update_event_mask(struct mkfw_window *state);
 MKFW_API void                 mkfw_window_get_native_handles(struct mkfw_window *state, struct mkfw_native_handles *out);
 
 /* Inline helper functions - placed after platform includes so struct is defined */
@@ -505,23 +770,29 @@ static inline uint32_t mkfw_window_get_modifiers(struct mkfw_window *state) {
 
 static inline void mkfw_set_error_callback(mkfw_error_callback_t callback) { mkfw_error_callback = callback; }
 static inline void mkfw_set_monitor_callback(struct mkfw_context *ctx, mkfw_monitor_callback_t callback) { ctx->monitor_callback = callback; }
+static inline void mkfw_set_pump_budget(struct mkfw_context *ctx, uint64_t nanoseconds, uint32_t events) { ctx->pump_budget_ns = nanoseconds; ctx->pump_budget_events = events; }
 static inline void mkfw_window_set_user_data(struct mkfw_window *state, void *user_data) { state->user_data = user_data; }
 static inline void *mkfw_window_get_user_data(struct mkfw_window *state) { return state->user_data; }
 static inline void mkfw_window_set_key_callback(struct mkfw_window *state, mkfw_key_callback_t callback) { state->key_callback = callback; }
-static inline void mkfw_window_set_char_callback(struct mkfw_window *state, mkfw_char_callback_t callback) { state->char_callback = callback; }
+static inline void mkfw_window_set_char_callback(struct mkfw_window *state, mkfw_char_callback_t callback) { state->char_callback = callback; mkfw_window_update_event_mask(state); }
 static inline void mkfw_window_set_scroll_callback(struct mkfw_window *state, mkfw_scroll_callback_t callback) { state->scroll_callback = callback; }
-static inline void mkfw_window_set_mouse_move_delta_callback(struct mkfw_window *state, mkfw_mouse_move_delta_callback_t callback) { state->mouse_move_delta_callback = callback; }
+static inline void mkfw_window_set_mouse_move_delta_callback(struct mkfw_window *state, mkfw_mouse_move_delta_callback_t callback) { state->mouse_move_delta_callback = callback; mkfw_window_update_event_mask(state); }
 static inline void mkfw_window_set_mouse_button_callback(struct mkfw_window *state, mkfw_mouse_button_callback_t callback) { state->mouse_button_callback = callback; }
 static inline void mkfw_window_set_framebuffer_size_callback(struct mkfw_window *state, mkfw_framebuffer_callback_t callback) { state->framebuffer_callback = callback; }
 static inline void mkfw_window_set_focus_callback(struct mkfw_window *state, mkfw_focus_callback_t callback) { state->focus_callback = callback; }
 static inline void mkfw_window_set_drop_callback(struct mkfw_window *state, mkfw_drop_callback_t callback) { state->drop_callback = callback; mkfw_window_enable_drop(state, callback != 0); }
 static inline void mkfw_window_set_state_callback(struct mkfw_window *state, mkfw_window_state_callback_t callback) { state->window_state_callback = callback; }
 static inline void mkfw_window_set_pos_callback(struct mkfw_window *state, mkfw_window_pos_callback_t callback) { state->window_pos_callback = callback; }
-static inline void mkfw_window_set_refresh_callback(struct mkfw_window *state, mkfw_window_refresh_callback_t callback) { state->window_refresh_callback = callback; }
+static inline void mkfw_window_set_refresh_callback(struct mkfw_window *state, mkfw_window_refresh_callback_t callback) { state->window_refresh_callback = callback; mkfw_window_update_event_mask(state); }
 static inline void mkfw_window_set_content_scale_callback(struct mkfw_window *state, mkfw_content_scale_callback_t callback) { state->content_scale_callback = callback; }
 static inline void mkfw_window_set_cursor_enter_callback(struct mkfw_window *state, mkfw_cursor_enter_callback_t callback) { state->cursor_enter_callback = callback; }
 static inline void mkfw_window_set_cursor_pos_callback(struct mkfw_window *state, mkfw_cursor_pos_callback_t callback) { state->cursor_pos_callback = callback; }
 static inline void mkfw_window_set_close_callback(struct mkfw_window *state, mkfw_close_callback_t callback) { state->close_callback = callback; }
+static inline void mkfw_window_set_key_timed_callback(struct mkfw_window *state, mkfw_key_timed_callback_t callback) { state->key_timed_callback = callback; }
+static inline void mkfw_window_set_mouse_button_timed_callback(struct mkfw_window *state, mkfw_mouse_button_timed_callback_t callback) { state->mouse_button_timed_callback = callback; }
+static inline void mkfw_window_set_cursor_pos_timed_callback(struct mkfw_window *state, mkfw_cursor_pos_timed_callback_t callback) { state->cursor_pos_timed_callback = callback; }
+static inline void mkfw_window_set_mouse_move_delta_timed_callback(struct mkfw_window *state, mkfw_mouse_move_delta_timed_callback_t callback) { state->mouse_move_delta_timed_callback = callback; mkfw_window_update_event_mask(state); }
+static inline void mkfw_window_set_scroll_timed_callback(struct mkfw_window *state, mkfw_scroll_timed_callback_t callback) { state->scroll_timed_callback = callback; }
 static inline uint32_t mkfw_window_is_key_pressed(struct mkfw_window *state, uint8_t key) { return state->keyboard_state[key] && !state->prev_keyboard_state[key]; }
 static inline uint32_t mkfw_window_was_key_released(struct mkfw_window *state, uint8_t key) { return !state->keyboard_state[key] && state->prev_keyboard_state[key]; }
 static inline uint32_t mkfw_window_is_scancode_down(struct mkfw_window *state, uint8_t scancode) { return state->scancode_state[scancode]; }
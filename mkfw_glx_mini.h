@@ -29,6 +29,7 @@ typedef XID GLXPbuffer;
 #define GLX_RGBA_BIT			0x00000001
 #define GLX_TRUE_COLOR		0x8002
 #define GLX_VENDOR			0x1
+#define GLX_VERSION			0x2
 
 #define GLX_SAMPLE_BUFFERS								0x186a0
 #define GLX_SAMPLES										0x186a1
@@ -43,8 +44,24 @@ typedef XID GLXPbuffer;
 #define GLX_CONTEXT_DEBUG_BIT_ARB						0x00000001
 #define GLX_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB		0x00000002
 
+#define GLX_BUFFER_SWAP_COMPLETE_INTEL_MASK			0x04000000
+#define GLX_BufferSwapComplete							1
+
 typedef struct __GLXFBConfigRec *GLXFBConfig;
 
+/* GLX_INTEL_swap_event; the drawable sits where XAnyEvent has its window. */
+typedef struct {
+	int type;
+	unsigned long serial;
+	Bool send_event;
+	Display *display;
+	GLXDrawable drawable;
+	int event_type;
+	int64_t ust;
+	int64_t msc;
+	int64_t sbc;
+} GLXBufferSwapComplete;
+
 typedef XVisualInfo *(*PFNGLXGETVISUALFROMFBCONFIGPROC)(Display *, GLXFBConfig);
 typedef GLXFBConfig *(*PFNGLXCHOOSEFBCONFIGPROC)(Display *, int, const int *, int *);
 typedef GLXContext (*PFNGLXCREATECONTEXTATTRIBSARBPROC)(Display *, GLXFBConfig, GLXContext, Bool, const int *);
@@ -54,6 +71,33 @@ typedef void (*PFNGLXSWAPBUFFERSPROC)(Display *, GLXDrawable);
 typedef const char *(*PFNGLXGETCLIENTSTRINGPROC)(Display *, int);
 typedef int (*PFNGLXGETFBCONFIGATTRIBPROC)(Display *, GLXFBConfig, int, int *);
 typedef GLXDrawable (*PFNGLXGETCURRENTDRAWABLEPROC)(void);
+typedef GLXContext (*PFNGLXGETCURRENTCONTEXTPROC)(void);
+typedef const char *(*PFNGLXQUERYSERVERSTRINGPROC)(Display *, int, int);
+typedef const char *(*PFNGLXQUERYEXTENSIONSSTRINGPROC)(Display *, int);
+typedef Bool (*PFNGLXGETSYNCVALUESOMLPROC)(Display *, GLXDrawable, int64_t *, int64_t *, int64_t *);
+typedef void (*PFNGLXSELECTEVENTPROC)(Display *, GLXDrawable, unsigned long);
+
+/* GLX_MESA_query_renderer: identifies the driver without a context. */
+#define GLX_RENDERER_VENDOR_ID_MESA						0x8183
+#define GLX_RENDERER_DEVICE_ID_MESA						0x8184
+#define GLX_RENDERER_VERSION_MESA						0x8185
+typedef Bool (*PFNGLXQUERYRENDERERINTEGERMESAPROC)(Display *, int, int, int, unsigned int *);
+
+/* Swap control: GLX_EXT_swap_control (+ _tear) and GLX_MESA_swap_control. */
+#define GLX_SWAP_INTERVAL_EXT							0x20f1
+#define GLX_LATE_SWAPS_TEAR_EXT							0x20f3
+typedef void (*PFNGLXSWAPINTERVALEXTPROC)(Display *, GLXDrawable, int);
+typedef void (*PFNGLXQUERYDRAWABLEPROC)(Display *, GLXDrawable, int, unsigned int *);
+typedef int (*PFNGLXSWAPINTERVALMESAPROC)(unsigned int);
+typedef int (*PFNGLXGETSWAPINTERVALMESAPROC)(void);
+
+/* GL 3.2 / ARB_sync, for frames_in_flight.  The sync object is a void *
+ * so these do not clash with a GL loader included alongside. */
+#define MKFW_GL_SYNC_GPU_COMMANDS_COMPLETE	0x9117
+#define MKFW_GL_SYNC_FLUSH_COMMANDS_BIT		0x00000001
+typedef void *(*PFN_mkfw_glFenceSync)(unsigned int, unsigned int);
+typedef unsigned int (*PFN_mkfw_glClientWaitSync)(void *, unsigned int, uint64_t);
+typedef void (*PFN_mkfw_glDeleteSync)(void *);
 
 static PFNGLXGETCURRENTDRAWABLEPROC glXGetCurrentDrawable;
 static PFNGLXGETVISUALFROMFBCONFIGPROC glXGetVisualFromFBConfig;
@@ -64,6 +108,8 @@ static PFNGLXSWAPBUFFERSPROC glXSwapBuffers;
 static PFNGLXDESTROYCONTEXTPROC glXDestroyContext;
 static PFNGLXGETCLIENTSTRINGPROC glXGetClientString;
 static PFNGLXGETFBCONFIGATTRIBPROC glXGetFBConfigAttrib;
+static PFNGLXGETCURRENTCONTEXTPROC glXGetCurrentContext;
+static PFNGLXQUERYSERVERSTRINGPROC glXQueryServerString;
 
 static void load_glx_functions(Display *display __attribute__((unused))) {
 	if(!mkfw_glXGetProcAddress) {
@@ -88,6 +134,8 @@ static void load_glx_functions(Display *display __attribute__((unused))) {
 	glXGetCurrentDrawable = (PFNGLXGETCURRENTDRAWABLEPROC)glXGetProcAddress((const unsigned char *)"glXGetCurrentDrawable");
 	glXGetClientString = (PFNGLXGETCLIENTSTRINGPROC)glXGetProcAddress((const unsigned char *)"glXGetClientString"); /* Added */
 	glXGetFBConfigAttrib = (PFNGLXGETFBCONFIGATTRIBPROC)glXGetProcAddress((const unsigned char *)"glXGetFBConfigAttrib"); /* Added */
+	glXGetCurrentContext = (PFNGLXGETCURRENTCONTEXTPROC)glXGetProcAddress((const unsigned char *)"glXGetCurrentContext"); /* Optional */
+	glXQueryServerString = (PFNGLXQUERYSERVERSTRINGPROC)glXGetProcAddress((const unsigned char *)"glXQueryServerString"); /* Optional */
 
 	if(!glXChooseFBConfig || !glXGetVisualFromFBConfig || !glXCreateContextAttribsARB || !glXMakeCurrent || !glXSwapBuffers || !glXDestroyContext || !glXGetCurrentDrawable || !glXGetClientString || !glXGetFBConfigAttrib) {
 		mkfw_error("failed to load GLX functions");
@@ -0,0 +1,466 @@
+// Copyright (c) 2025-2026 Peter Fors
+// SPDX-License-Identifier: MIT
+
+// Helpers shared by the platform back ends: input delivery, the window
+// list and pool, async requests, present timing and frame pacing.  Not
+// part of the public API; included by mkfw_linux.c and mkfw_win32.c
+// after mkfw.h.
+
+#pragma once
+
+#include <stddef.h>
+
+// In unity mode this is reached before the prototypes at the end of mkfw.h.
+MKFW_API uint64_t mkfw_get_time(void);
+MKFW_API void     mkfw_sleep(uint64_t nanoseconds);
+
+/* Ring setup shared by the platform back ends' mkfw_init.  capacity is
+ * rounded up to a power of two, 0 = 1024.  Returns 0 on allocation
+ * failure. */
+static inline uint32_t mkfw_event_ring_create(struct mkfw_event_ring *ring, uint32_t capacity) {
+	uint32_t size = 1024;
+	if(capacity) {
+		size = 1;
+		while(size < capacity && size < (1u << 31)) {
+			size <<= 1;
+		}
+	}
+	ring->events = (struct mkfw_event *)calloc(size, sizeof(struct mkfw_event));
+	ring->mask = size - 1;
+	return ring->events != 0;
+}
+
+// [=]===^=[ mkfw_options_load ]==================================================================[=]
+// Copy the caller's init options into the current layout; see the
+// version note on mkfw_options.  0 opts gives the defaults.
+static inline void mkfw_options_load(struct mkfw_options *out, struct mkfw_options *opts) {
+	memset(out, 0, sizeof(*out));
+	if(opts && opts->version >= 1) {
+		*out = *opts;
+	}
+	out->version = MKFW_OPTIONS_VERSION;
+}
+
+/* Copies the platform-independent mkfw_options into a new context and
+ * sets up the MKFW_INIT_EVENT_QUEUE ring.  Returns 0 on allocation
+ * failure. */
+static inline uint32_t mkfw_context_apply_options(struct mkfw_context *ctx, struct mkfw_options *opts) {
+	if(!opts) {
+		return 1;
+	}
+	ctx->flags = opts->flags;
+	ctx->pump_budget_events = opts->pump_budget_events;
+	ctx->pump_budget_ns = opts->pump_budget_ns;
+	if(!(opts->flags & MKFW_INIT_EVENT_QUEUE)) {
+		return 1;
+	}
+	return mkfw_event_ring_create(&ctx->event_queue, opts->event_queue_capacity);
+}
+
+/* Producer side; only the ring's producer thread calls this. */
+static inline void mkfw_event_ring_push(struct mkfw_event_ring *ring, struct mkfw_event *ev) {
+	uint32_t head = ring->head;
+	uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	if(head - tail > ring->mask) {
+		++ring->dropped;
+		return;
+	}
+	ring->events[head & ring->mask] = *ev;
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+/* Consumer side; returns 0 when the ring is empty or not in use. */
+static inline uint32_t mkfw_event_ring_pop(struct mkfw_event_ring *ring, struct mkfw_event *out) {
+	if(!ring->events) {
+		return 0;
+	}
+	uint32_t tail = ring->tail;
+	uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	if(tail == head) {
+		return 0;
+	}
+	*out = ring->events[tail & ring->mask];
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+	return 1;
+}
+
+/* Input delivery used by the platform back ends: a queued record in
+ * MKFW_INIT_EVENT_QUEUE mode, otherwise the window's callbacks, if any.
+ * time is the event's own timestamp on the mkfw_get_time() clock. */
+#define MKFW_EVENT_INIT(ev, w, t, when) struct mkfw_event ev; memset(&ev, 0, sizeof(ev)); ev.type = (t); ev.window = (w); ev.time = (when)
+
+static inline void mkfw_emit_key(struct mkfw_window *w, uint64_t time, uint32_t key, uint32_t action, uint32_t modifier_bits) {
+	if(w->context->event_queue.events) {
+		MKFW_EVENT_INIT(ev, w, MKFW_EVENT_KEY, time);
+		ev.key.key = key;
+		ev.key.action = action;
+		ev.key.modifier_bits = modifier_bits;
+		mkfw_event_ring_push(&w->context->event_queue, &ev);
+	} else {
+		if(w->key_callback) {
+			w->key_callback(w, key, action, modifier_bits);
+		}
+		if(w->key_timed_callback) {
+			w->key_timed_callback(w, key, action, modifier_bits, time);
+		}
+	}
+}
+
+static inline void mkfw_emit_char(struct mkfw_window *w, uint64_t time, uint32_t codepoint) {
+	if(w->context->event_queue.events) {
+		MKFW_EVENT_INIT(ev, w, MKFW_EVENT_CHAR, time);
+		ev.character.codepoint = codepoint;
+		mkfw_event_ring_push(&w->context->event_queue, &ev);
+	} else if(w->char_callback) {
+		w->char_callback(w, codepoint);
+	}
+}
+
+static inline void mkfw_emit_mouse_button(struct mkfw_window *w, uint64_t time, uint8_t button, uint32_t action) {
+	if(w->context->event_queue.events) {
+		MKFW_EVENT_INIT(ev, w, MKFW_EVENT_MOUSE_BUTTON, time);
+		ev.button.button = button;
+		ev.button.action = action;
+		mkfw_event_ring_push(&w->context->event_queue, &ev);
+	} else {
+		if(w->mouse_button_callback) {
+			w->mouse_button_callback(w, button, action);
+		}
+		if(w->mouse_button_timed_callback) {
+			w->mouse_button_timed_callback(w, button, action, time);
+		}
+	}
+}
+
+static inline void mkfw_emit_cursor_pos(struct mkfw_window *w, uint64_t time, int32_t x, int32_t y) {
+	if(w->context->event_queue.events) {
+		MKFW_EVENT_INIT(ev, w, MKFW_EVENT_CURSOR_POS, time);
+		ev.pos.x = x;
+		ev.pos.y = y;
+		mkfw_event_ring_push(&w->context->event_queue, &ev);
+	} else {
+		if(w->cursor_pos_callback) {
+			w->cursor_pos_callback(w, x, y);
+		}
+		if(w->cursor_pos_timed_callback) {
+			w->cursor_pos_timed_callback(w, x, y, time);
+		}
+	}
+}
+
+static inline void mkfw_emit_cursor_enter(struct mkfw_window *w, uint64_t time, uint8_t entered) {
+	if(w->context->event_queue.events) {
+		MKFW_EVENT_INIT(ev, w, MKFW_EVENT_CURSOR_ENTER, time);
+		ev.state = entered;
+		mkfw_event_ring_push(&w->context->event_queue, &ev);
+	} else if(w->cursor_enter_callback) {
+		w->cursor_enter_callback(w, entered);
+	}
+}
+
+static inline void mkfw_emit_mouse_delta(struct mkfw_window *w, uint64_t time, int32_t dx, int32_t dy) {
+	if(w->context->event_queue.events) {
+		MKFW_EVENT_INIT(ev, w, MKFW_EVENT_MOUSE_DELTA, time);
+		ev.delta.dx = dx;
+		ev.delta.dy = dy;
+		mkfw_event_ring_push(&w->context->event_queue, &ev);
+	} else {
+		if(w->mouse_move_delta_callback) {
+			w->mouse_move_delta_callback(w, dx, dy);
+		}
+		if(w->mouse_move_delta_timed_callback) {
+			w->mouse_move_delta_timed_callback(w, dx, dy, time);
+		}
+	}
+}
+
+/* Running sum of raw mouse motion not yet reported.  Whole units are
+ * emitted on flush; the fraction stays for the next one so the emitted
+ * total matches the device total.  time is that of the newest motion. */
+struct mkfw_delta_accumulator {
+	double dx;
+	double dy;
+	uint64_t time;
+	uint8_t pending;
+};
+
+static inline void mkfw_delta_add(struct mkfw_delta_accumulator *acc, uint64_t time, double dx, double dy) {
+	acc->dx += dx;
+	acc->dy += dy;
+	acc->time = time;
+	acc->pending = 1;
+}
+
+/* Takes the whole-unit part out of the accumulator; returns 0 when there
+ * is nothing to report. */
+static inline uint32_t mkfw_delta_take(struct mkfw_delta_accumulator *acc, int32_t *dx, int32_t *dy) {
+	if(!acc->pending) {
+		return 0;
+	}
+	acc->pending = 0;
+	*dx = (int32_t)acc->dx;
+	*dy = (int32_t)acc->dy;
+	acc->dx -= *dx;
+	acc->dy -= *dy;
+	return *dx || *dy;
+}
+
+/* MKFW_INIT_COALESCE_MOTION: report a window's merged delta. */
+static inline void mkfw_delta_flush(struct mkfw_window *w, struct mkfw_delta_accumulator *acc) {
+	int32_t dx, dy;
+	if(mkfw_delta_take(acc, &dx, &dy)) {
+		mkfw_emit_mouse_delta(w, acc->time, dx, dy);
+	}
+}
+
+/* Budget check for the platform pump loops; handled counts events
+ * dispatched so far, deadline is 0 without a time budget.  The clock is
+ * read every 16 events. */
+static inline uint32_t mkfw_pump_budget_spent(struct mkfw_context *ctx, uint32_t handled, uint64_t deadline) {
+	if(ctx->pump_budget_events && handled >= ctx->pump_budget_events) {
+		return 1;
+	}
+	return deadline && (handled & 15) == 0 && mkfw_get_time() >= deadline;
+}
+
+static inline void mkfw_emit_scroll(struct mkfw_window *w, uint64_t time, double x, double y) {
+	if(w->context->event_queue.events) {
+		MKFW_EVENT_INIT(ev, w, MKFW_EVENT_SCROLL, time);
+		ev.scroll.x = x;
+		ev.scroll.y = y;
+		mkfw_event_ring_push(&w->context->event_queue, &ev);
+	} else {
+		if(w->scroll_callback) {
+			w->scroll_callback(w, x, y);
+		}
+		if(w->scroll_timed_callback) {
+			w->scroll_timed_callback(w, x, y, time);
+		}
+	}
+}
+
+static inline void mkfw_emit_focus(struct mkfw_window *w, uint64_t time, uint8_t focused) {
+	if(w->context->event_queue.events) {
+		MKFW_EVENT_INIT(ev, w, MKFW_EVENT_FOCUS, time);
+		ev.state = focused;
+		mkfw_event_ring_push(&w->context->event_queue, &ev);
+	} else if(w->focus_callback) {
+		w->focus_callback(w, focused);
+	}
+}
+
+static inline void mkfw_emit_framebuffer_size(struct mkfw_window *w, uint64_t time, int32_t width, int32_t height, float aspect_ratio) {
+	if(w->context->event_queue.events) {
+		MKFW_EVENT_INIT(ev, w, MKFW_EVENT_FRAMEBUFFER_SIZE, time);
+		ev.size.width = width;
+		ev.size.height = height;
+		mkfw_event_ring_push(&w->context->event_queue, &ev);
+	} else if(w->framebuffer_callback) {
+		w->framebuffer_callback(w, width, height, aspect_ratio);
+	}
+}
+
+static inline void mkfw_emit_close(struct mkfw_window *w, uint64_t time) {
+	if(w->context->event_queue.events) {
+		MKFW_EVENT_INIT(ev, w, MKFW_EVENT_CLOSE, time);
+		mkfw_event_ring_push(&w->context->event_queue, &ev);
+	} else if(w->close_callback) {
+		w->close_callback(w);
+	}
+}
+
+// [=]===^=[ mkfw_present_record ]================================================================[=]
+// Fold one timing sample into ps.  msc is 0 for sources without a vblank
+// counter; there a gap of more than one and a half periods between swaps
+// counts as missed vblanks and is kept out of the refresh estimate.
+static inline void mkfw_present_record(struct mkfw_present_stats *ps, uint64_t ust_ns, uint64_t msc, uint64_t sbc) {
+	if(ps->ust_ns && ust_ns > ps->ust_ns && sbc >= ps->sbc) {
+		uint64_t frames = sbc - ps->sbc;
+		uint64_t elapsed = ust_ns - ps->ust_ns;
+		uint64_t period = 0;
+		if(msc > ps->msc) {
+			uint64_t vblanks = msc - ps->msc;
+			if(vblanks > frames) {
+				ps->missed_vblanks += vblanks - frames;
+			}
+			period = elapsed / vblanks;
+		} else if(!msc && frames) {
+			period = elapsed / frames;
+			if(ps->refresh_ns && period > ps->refresh_ns + ps->refresh_ns / 2) {
+				uint64_t vblanks = (elapsed + ps->refresh_ns / 2) / ps->refresh_ns;
+				ps->missed_vblanks += vblanks > frames ? vblanks - frames : 0;
+				period = 0;
+			}
+		}
+		if(period) {
+			ps->refresh_ns = ps->refresh_ns ? ps->refresh_ns - ps->refresh_ns / 8 + period / 8 : period;
+		}
+	}
+	ps->ust_ns = ust_ns;
+	ps->msc = msc;
+	ps->sbc = sbc;
+}
+
+// Flags fixed when the native window is created; the rest (HIDDEN,
+// RECYCLE, POLL_DELTA) are applied at hand-out.
+#define MKFW_WIN_POOL_KEY_FLAGS (MKFW_WIN_TRANSPARENT | MKFW_WIN_FLOATING | MKFW_WIN_MAXIMIZED | MKFW_WIN_NO_FOCUS)
+
+// [=]===^=[ mkfw_window_options_load ]===========================================================[=]
+// Copy the caller's options into the current layout.  Fields newer than
+// opts->version stay 0 and are not read, since the caller's struct may end
+// before them.  0 opts gives the defaults.
+static inline void mkfw_window_options_load(struct mkfw_window_options *out, struct mkfw_window_options *opts) {
+	memset(out, 0, sizeof(*out));
+	if(opts) {
+		memcpy(out, opts, offsetof(struct mkfw_window_options, frames_in_flight));
+		if(opts->version >= 1) {
+			out->frames_in_flight = opts->frames_in_flight;
+		}
+	}
+	out->version = MKFW_WINDOW_OPTIONS_VERSION;
+}
+
+// [=]===^=[ mkfw_window_options_compatible ]=====================================================[=]
+// Whether a window created with options a can be handed out for a request
+// with options b: same graphics API, GL context and pixel-format hints,
+// share window and creation-time flags.  Size, title and class name are
+// applied to the pooled window, so they need not match.
+static inline uint32_t mkfw_window_options_compatible(struct mkfw_window_options *a, struct mkfw_window_options *b) {
+	int32_t a_samples = a->samples > 1 ? a->samples : 0;
+	int32_t b_samples = b->samples > 1 ? b->samples : 0;
+	return a->graphics_api == b->graphics_api &&
+		a->gl_major == b->gl_major && a->gl_minor == b->gl_minor &&
+		a->gl_profile == b->gl_profile && a->context_flags == b->context_flags &&
+		a->depth_bits == b->depth_bits && a->stencil_bits == b->stencil_bits &&
+		a_samples == b_samples && !a->srgb == !b->srgb &&
+		a->share_window == b->share_window &&
+		(a->flags & MKFW_WIN_POOL_KEY_FLAGS) == (b->flags & MKFW_WIN_POOL_KEY_FLAGS);
+}
+
+// [=]===^=[ mkfw_window_request_queue ]==========================================================[=]
+// Append req to the context's pending list.
+static inline void mkfw_window_request_queue(struct mkfw_context *ctx, struct mkfw_window_options *opts, struct mkfw_window_request *req) {
+	mkfw_window_options_load(&req->options, opts);
+	req->window = 0;
+	req->ready = 0;
+	req->next = 0;
+
+	struct mkfw_window_request **tail = &ctx->window_requests;
+	while(*tail) {
+		tail = &(*tail)->next;
+	}
+	*tail = req;
+	++ctx->window_request_count;
+}
+
+// [=]===^=[ mkfw_window_request_pop ]============================================================[=]
+static inline struct mkfw_window_request *mkfw_window_request_pop(struct mkfw_context *ctx) {
+	struct mkfw_window_request *req = ctx->window_requests;
+	if(req) {
+		ctx->window_requests = req->next;
+		req->next = 0;
+		--ctx->window_request_count;
+	}
+	return req;
+}
+
+// [=]===^=[ mkfw_context_reserve_window ]========================================================[=]
+// Make room in ctx->windows[] for one more window, doubling the array
+// when it is full.  Returns 0 if it could not grow.
+static inline uint32_t mkfw_context_reserve_window(struct mkfw_context *ctx) {
+	if(ctx->window_count < ctx->window_capacity) {
+		return 1;
+	}
+	uint32_t capacity = ctx->window_capacity ? ctx->window_capacity * 2 : 16;
+	struct mkfw_window **windows = (struct mkfw_window **)realloc(ctx->windows, capacity * sizeof(*windows));
+	if(!windows) {
+		mkfw_error("mkfw_window_create: out of memory growing the window list to %u", capacity);
+		return 0;
+	}
+	ctx->windows = windows;
+	ctx->window_capacity = capacity;
+	return 1;
+}
+
+// [=]===^=[ mkfw_context_link_window ]===========================================================[=]
+// Append a window to ctx->windows[]; mkfw_context_reserve_window first.
+static inline void mkfw_context_link_window(struct mkfw_context *ctx, struct mkfw_window *w) {
+	w->context_index = ctx->window_count;
+	ctx->windows[ctx->window_count++] = w;
+}
+
+// [=]===^=[ mkfw_context_unlink_window ]=========================================================[=]
+// Drop a window from ctx->windows[], closing the gap so the rest stay in
+// creation order.  Only the pointers behind it move.
+static inline void mkfw_context_unlink_window(struct mkfw_context *ctx, struct mkfw_window *w) {
+	uint32_t i = w->context_index;
+	if(i >= ctx->window_count || ctx->windows[i] != w) {
+		return;
+	}
+	--ctx->window_count;
+	for(; i < ctx->window_count; ++i) {
+		ctx->windows[i] = ctx->windows[i + 1];
+		ctx->windows[i]->context_index = i;
+	}
+	ctx->windows[ctx->window_count] = 0;
+}
+
+// [=]===^=[ mkfw_monitor_refresh_at ]============================================================[=]
+// Refresh rate of the cached monitor containing (x, y), else of the
+// primary monitor; 0 if neither is known.
+static inline int32_t mkfw_monitor_refresh_at(struct mkfw_context *ctx, int32_t x, int32_t y) {
+	int32_t primary = 0;
+	for(uint32_t i = 0; i < ctx->monitor_count; ++i) {
+		struct mkfw_monitor *m = &ctx->monitors[i];
+		if(x >= m->x && x < m->x + m->width && y >= m->y && y < m->y + m->height) {
+			return m->refresh_rate;
+		}
+		if(m->primary) {
+			primary = m->refresh_rate;
+		}
+	}
+	return primary;
+}
+
+// [=]===^=[ mkfw_pacer_wait ]====================================================================[=]
+// Learn the render time of the frame that just ended, predict the first
+// vblank it can still make, and sleep, then spin for the last spin_ns,
+// until that vblank minus the render time and margin.  Returns the vblank.
+static inline uint64_t mkfw_pacer_wait(struct mkfw_frame_pacer *p, struct mkfw_present_stats *ps, int32_t monitor_hz, uint64_t spin_ns) {
+	if(p->wake_ns && ps->submit_ns > p->wake_ns) {
+		p->history[p->history_index] = ps->submit_ns - p->wake_ns;
+		p->history_index = (p->history_index + 1) % MKFW_PACER_HISTORY;
+	}
+	uint64_t render = 0;
+	for(uint32_t i = 0; i < MKFW_PACER_HISTORY; ++i) {
+		render = p->history[i] > render ? p->history[i] : render;
+	}
+
+	uint64_t period = p->refresh_ns;
+	if(!period) {
+		period = ps->refresh_ns ? ps->refresh_ns : 1000000000ULL / (uint64_t)(monitor_hz > 0 ? monitor_hz : 60);
+	}
+	uint64_t margin = p->margin_ns ? p->margin_ns : 1000000;
+
+	// Step whole periods from the last known vblank (or from now, before
+	// the first swap) to the first one the frame can still reach.
+	uint64_t now = mkfw_get_time();
+	uint64_t anchor = ps->ust_ns ? ps->ust_ns : now;
+	uint64_t earliest = now + render + margin;
+	uint64_t vblank = anchor;
+	if(earliest > anchor) {
+		vblank += (earliest - anchor + period - 1) / period * period;
+	}
+
+	uint64_t deadline = vblank - render - margin;
+	if(deadline > now + spin_ns) {
+		mkfw_sleep(deadline - now - spin_ns);
+	}
+	while(mkfw_get_time() < deadline) {
+	}
+
+	p->render_ns = render;
+	p->vblank_ns = vblank;
+	p->wake_ns = mkfw_get_time();
+	return vblank;
+}
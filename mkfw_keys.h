@@ -142,7 +142,8 @@ enum {
 
 enum {
 	MKFW_RELEASED = 0,
-	MKFW_PRESSED
+	MKFW_PRESSED,
+	MKFW_REPEAT						// key held; keyboard_state is not touched
 };
 
 enum {
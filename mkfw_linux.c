@@ -10,6 +10,7 @@
 #include <X11/Xlib.h>
 #include <X11/keysym.h>
 #include <X11/Xutil.h>
+#include <X11/XKBlib.h>
 #include <X11/cursorfont.h>
 #include <X11/extensions/XInput2.h>
 #include <X11/extensions/XI.h>
@@ -17,11 +18,13 @@
 #include <X11/extensions/Xrandr.h>
 
 #include <poll.h>
+#include <pthread.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
 
 #include <X11/Xresource.h>
 
@@ -29,6 +32,7 @@
 #include "mkfw_linux_xlib_loader.h"
 #include "mkfw_linux_xrandr_loader.h"
 #include "mkfw_linux_xinput2_loader.h"
+#include "mkfw_internal.h"
 
 /* Storage for the cross-TU variables declared MKFW_VAR in mkfw.h.
  * Provided only in library / shared builds; in unity mode the
@@ -72,18 +76,248 @@ MKFW_API void mkfw_clear_last_error(void) {
 #define PLATFORM(state) ((struct x11_mkfw_window *)(state)->platform)
 #define CTX_PLATFORM(c) ((struct x11_mkfw_context *)(c)->platform)
 #define WIN_CTX_PLATFORM(w) CTX_PLATFORM((w)->context)
+#define X11_ATOM(w, name) (WIN_CTX_PLATFORM(w)->atoms[X11_ATOM_##name])
+
+// [=]===^=[ x11_round_trips ]====================================================================[=]
+// Records n requests on the context's connection that block until the
+// server replies; surfaced to callers through mkfw_context.stats.
+static inline void x11_round_trips(struct mkfw_context *ctx, uint32_t n) {
+	ctx->stats.round_trips += n;
+}
+
+/* Initial slots in the XID routing table.  The table doubles before it
+ * is half full, which keeps probe chains short; must stay a power of two. */
+#define MKFW_X11_WINDOW_MAP_SIZE 64
+
+struct x11_window_slot {
+	Window xid;
+	struct mkfw_window *window;
+};
+
+/* X server time (milliseconds, wraps at 2^32) mapped onto the
+ * mkfw_get_time() clock. */
+struct x11_server_clock {
+	Time     ref;
+	uint64_t ref_ns;
+};
+
+/* One slot per X keycode: everything a key event needs, resolved from the
+ * keyboard mapping when it is fetched instead of on every press. */
+struct x11_keymap_entry {
+	uint16_t key;        // MKFW_KEY_*, 0 = not mapped
+	uint8_t  scancode;   // USB HID usage, 0 = none
+	uint8_t  modifier;   // MKFW_MOD_* bit of a modifier key, else 0
+};
+
+/* Every atom mkfw uses, interned once per context in mkfw_init with a
+ * single XInternAtoms request and shared by all its windows.  Keep
+ * x11_atom_names in the same order. */
+enum x11_atom {
+	X11_ATOM_WM_DELETE_WINDOW,
+	X11_ATOM_WM_STATE,
+	X11_ATOM_CLIPBOARD,
+	X11_ATOM_UTF8_STRING,
+	X11_ATOM_TARGETS,
+	X11_ATOM_MKFW_CLIPBOARD,
+	X11_ATOM_XDND_AWARE,
+	X11_ATOM_XDND_ENTER,
+	X11_ATOM_XDND_POSITION,
+	X11_ATOM_XDND_STATUS,
+	X11_ATOM_XDND_LEAVE,
+	X11_ATOM_XDND_DROP,
+	X11_ATOM_XDND_FINISHED,
+	X11_ATOM_XDND_SELECTION,
+	X11_ATOM_XDND_TYPE_LIST,
+	X11_ATOM_TEXT_URI_LIST,
+	X11_ATOM_NET_WM_STATE,
+	X11_ATOM_NET_WM_STATE_MAXIMIZED_HORZ,
+	X11_ATOM_NET_WM_STATE_MAXIMIZED_VERT,
+	X11_ATOM_NET_WM_STATE_DEMANDS_ATTENTION,
+	X11_ATOM_NET_WM_STATE_ABOVE,
+	X11_ATOM_NET_WM_STATE_FULLSCREEN,
+	X11_ATOM_NET_WM_USER_TIME,
+	X11_ATOM_NET_WM_NAME,
+	X11_ATOM_NET_WM_ICON,
+	X11_ATOM_NET_WM_WINDOW_OPACITY,
+	X11_ATOM_NET_ACTIVE_WINDOW,
+	X11_ATOM_NET_WORKAREA,
+	X11_ATOM_MOTIF_WM_HINTS,
+	X11_ATOM_COUNT
+};
+
+static char *x11_atom_names[X11_ATOM_COUNT] = {
+	"WM_DELETE_WINDOW",
+	"WM_STATE",
+	"CLIPBOARD",
+	"UTF8_STRING",
+	"TARGETS",
+	"MKFW_CLIPBOARD",
+	"XdndAware",
+	"XdndEnter",
+	"XdndPosition",
+	"XdndStatus",
+	"XdndLeave",
+	"XdndDrop",
+	"XdndFinished",
+	"XdndSelection",
+	"XdndTypeList",
+	"text/uri-list",
+	"_NET_WM_STATE",
+	"_NET_WM_STATE_MAXIMIZED_HORZ",
+	"_NET_WM_STATE_MAXIMIZED_VERT",
+	"_NET_WM_STATE_DEMANDS_ATTENTION",
+	"_NET_WM_STATE_ABOVE",
+	"_NET_WM_STATE_FULLSCREEN",
+	"_NET_WM_USER_TIME",
+	"_NET_WM_NAME",
+	"_NET_WM_ICON",
+	"_NET_WM_WINDOW_OPACITY",
+	"_NET_ACTIVE_WINDOW",
+	"_NET_WORKAREA",
+	"_MOTIF_WM_HINTS",
+};
+
+/* One window-renderable fbconfig with the attributes the selector scores,
+ * fetched once per context (x11_context_fbconfigs).  visual_depth is -1
+ * until a transparent window first needs it. */
+struct x11_fbconfig {
+	GLXFBConfig config;
+	uint8_t red, green, blue, alpha;
+	uint8_t depth, stencil, samples, sample_buffers;
+	uint8_t doublebuffer, srgb;
+	int8_t  visual_depth;
+};
 
 struct x11_mkfw_context {
 	Display *display;
 	uint8_t libs_loaded;
 	uint8_t signal_handlers_installed;
 
+	// Loads the libraries mkfw_init does not wait for; see x11_loader_main.
+	// loader_ns is the thread's result, published to ctx->stats by
+	// x11_loader_reap once loader_done is set.
+	pthread_t loader_thread;
+	uint8_t   loader_running;
+	uint32_t  loader_done;
+	uint64_t  loader_ns;
+
+	// Thread that called mkfw_init; MKFW_DEBUG builds check X entry points
+	// against it under MKFW_INIT_NO_X_THREADS.
+	pthread_t owner_thread;
+	uint8_t   thread_error_reported;
+
+	// Background GL version probe for mkfw_window_create_async, run on the
+	// context's connection with an fbconfig picked by the pump; see
+	// x11_gl_probe_main.  probe_error is handed to mkfw_error by the pump.
+	pthread_t   probe_thread;
+	uint8_t     probe_running;
+	uint32_t    probe_done;
+	GLXFBConfig probe_fbconfig;
+	int32_t     probe_major;
+	int32_t     probe_minor;
+	const char *probe_error;
+
+	// mkfw_begin_batch nesting depth; while nonzero setters leave requests
+	// queued, and batch_sync records that one of them wanted an XSync.
+	uint32_t batch_depth;
+	uint8_t  batch_sync;
+
 	// Per-monitor XRandR handles, parallel to mkfw_context.monitors[] (same
 	// order, primary first), used for video-mode enumeration and mode setting.
 	RRCrtc   monitor_crtc[MKFW_MAX_MONITORS];
 	RROutput monitor_output[MKFW_MAX_MONITORS];
 
 	int32_t xrandr_event_base;   // base for RRScreenChangeNotify, or -1 if unavailable
+
+	// XID -> mkfw_window routing table for mkfw_poll_events.  Open
+	// addressing with linear probing; an empty slot has xid == None.
+	// Holds live and pooled windows.
+	struct x11_window_slot *window_map;
+	uint32_t window_map_mask;    // slots - 1; 0 until the first window
+	uint32_t window_map_count;
+
+	// Window the pointer is currently inside; XInput2 generic events carry
+	// no window and are routed here.
+	struct mkfw_window *pointer_window;
+
+	uint8_t warp_pending;   // some window has warp_pending set
+
+	// Interned in mkfw_init; index with enum x11_atom or X11_ATOM().
+	Atom atoms[X11_ATOM_COUNT];
+
+	// Shared by all windows and created on first use: the standard cursor
+	// shapes (x11_shape_cursor), the blank cursor for hidden pointers, and
+	// the input method, which is opened when the first window wants
+	// characters since XOpenIM talks to ibus/fcitx.
+	Cursor cursors[MKFW_CURSOR_LAST];
+	Cursor hidden_cursor;
+	XIM xim;
+	uint8_t xim_opened;
+
+	// Keycode translation, built in mkfw_init and on MappingNotify.
+	struct x11_keymap_entry keymap[256];
+
+	// XkbSetDetectableAutoRepeat took effect: held keys arrive as repeated
+	// KeyPress events with no synthetic KeyRelease in between.
+	uint8_t detectable_repeat;
+
+	// XInput2 opcode, queried once in mkfw_init (-1 when unavailable), and
+	// whether XI_RawMotion is currently selected on the root window.  Raw
+	// motion wakes us on every mouse move anywhere on the desktop, so it is
+	// selected only while some window that consumes deltas is focused or
+	// has the cursor locked (x11_update_raw_motion).
+	int32_t xi_opcode;
+	uint8_t raw_motion_selected;
+
+	// Driver's maximum GL version for gl_major == 0 windows, probed at most
+	// once (x11_context_gl_version).  gl_version_cache is the optional
+	// persistent cache path from mkfw_options, owned by the context.
+	int32_t gl_max_major;
+	int32_t gl_max_minor;
+	uint8_t gl_probed;
+	uint8_t gl_from_cache;   // gl_max_* came from gl_version_cache
+	char *gl_version_cache;
+
+	// fbconfig attribute table, fetched on the first GL window or probe.
+	struct x11_fbconfig *fbconfigs;
+	uint32_t fbconfig_count;
+	uint8_t fbconfigs_fetched;
+
+	// Present timing source, resolved on the first GL window
+	// (x11_present_resolve).  glx_event_base offsets GLX_BufferSwapComplete.
+	uint8_t  present_resolved;
+	uint32_t present_source;
+	int32_t  glx_event_base;
+	PFNGLXGETSYNCVALUESOMLPROC glXGetSyncValuesOML;
+
+	// Swap control, resolved with the above.  The EXT calls take the
+	// drawable; MESA's act on whatever is current.
+	uint32_t swap_caps;   // MKFW_SWAP_CAP_*
+	PFNGLXSWAPINTERVALEXTPROC     glXSwapIntervalEXT;
+	PFNGLXQUERYDRAWABLEPROC       glXQueryDrawable;
+	PFNGLXSWAPINTERVALMESAPROC    glXSwapIntervalMESA;
+	PFNGLXGETSWAPINTERVALMESAPROC glXGetSwapIntervalMESA;
+
+	// ARB_sync entry points for frames_in_flight, resolved with the above.
+	PFN_mkfw_glFenceSync      glFenceSync;
+	PFN_mkfw_glClientWaitSync glClientWaitSync;
+	PFN_mkfw_glDeleteSync     glDeleteSync;
+
+	// Calibrated once in mkfw_init; the input thread works on its own copy.
+	struct x11_server_clock server_clock;
+
+	// Raw input thread (MKFW_INIT_INPUT_THREAD).  It owns input_display so
+	// it never contends with the pump for the main connection's lock.
+	Display  *input_display;
+	pthread_t input_thread;
+	int32_t   input_wake[2];   // pipe; writing to [1] stops the thread
+	int32_t   input_xi_opcode;
+	uint8_t   input_thread_running;
+
+	// Raw button events carry the physical button; the pointer mapping,
+	// fetched once at thread start, turns it into the logical one.
+	uint8_t   input_button_map[256];
+	int32_t   input_button_count;
 };
 
 /* libXcursor minimal loader.  Used by mkfw_cursor_create_rgba; missing
@@ -120,6 +354,119 @@ static uint32_t load_xcursor_functions(void) {
 	return mkfw_XcursorImageCreate && mkfw_XcursorImageDestroy && mkfw_XcursorImageLoadCursor;
 }
 
+// Every library loads once per process under a pthread_once, so the
+// loader thread started by mkfw_init, a caller that needs a library first
+// and mkfw_query_max_gl_version on another thread can race freely: the
+// loser waits for the winner.  If the thread cannot be started each
+// library simply loads on first use.
+static pthread_once_t x11_x11_once     = PTHREAD_ONCE_INIT;
+static pthread_once_t x11_xrandr_once  = PTHREAD_ONCE_INIT;
+static pthread_once_t x11_xinput2_once = PTHREAD_ONCE_INIT;
+static pthread_once_t x11_glx_once     = PTHREAD_ONCE_INIT;
+static pthread_once_t x11_xcursor_once = PTHREAD_ONCE_INIT;
+
+// [=]===^=[ x11_load_glx_once ]==================================================================[=]
+static void x11_load_glx_once(void) {
+	load_glx_functions(0);
+}
+
+// [=]===^=[ x11_load_xcursor_once ]==============================================================[=]
+static void x11_load_xcursor_once(void) {
+	load_xcursor_functions();   // optional: missing libXcursor disables custom cursors
+}
+
+// [=]===^=[ x11_need_x11 ]=======================================================================[=]
+static void x11_need_x11(void) {
+	pthread_once(&x11_x11_once, load_x11_functions);
+}
+
+// [=]===^=[ x11_need_xrandr ]====================================================================[=]
+static void x11_need_xrandr(void) {
+	pthread_once(&x11_xrandr_once, load_xrandr_functions);
+}
+
+// [=]===^=[ x11_need_xinput2 ]===================================================================[=]
+static void x11_need_xinput2(void) {
+	pthread_once(&x11_xinput2_once, load_xinput2_functions);
+}
+
+// [=]===^=[ x11_need_glx ]=======================================================================[=]
+static void x11_need_glx(void) {
+	pthread_once(&x11_glx_once, x11_load_glx_once);
+}
+
+// [=]===^=[ x11_need_xcursor ]===================================================================[=]
+static void x11_need_xcursor(void) {
+	pthread_once(&x11_xcursor_once, x11_load_xcursor_once);
+}
+
+// [=]===^=[ x11_check_thread ]===================================================================[=]
+// Without XInitThreads, Xlib has no lock around the display, so an X call
+// from a second thread races the owning one.  Reported once per context.
+#ifdef MKFW_DEBUG
+#define X11_CHECK_THREAD(ctx) x11_check_thread((ctx), __func__)
+static void x11_check_thread(struct mkfw_context *ctx, const char *func) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	if(!(ctx->flags & MKFW_INIT_NO_X_THREADS) || xc->thread_error_reported || pthread_equal(pthread_self(), xc->owner_thread)) {
+		return;
+	}
+	xc->thread_error_reported = 1;
+	mkfw_error("%s: called from a thread other than the owning thread of an MKFW_INIT_NO_X_THREADS context", func);
+}
+#else
+#define X11_CHECK_THREAD(ctx) ((void)0)
+#endif
+
+// [=]===^=[ x11_flush ]==========================================================================[=]
+// Send queued requests to the server, or leave them for mkfw_commit_batch
+// while a batch is open.  Setters end with this instead of XFlush.
+static void x11_flush(struct mkfw_context *ctx) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	if(xc->batch_depth) {
+		return;
+	}
+	XFlush(xc->display);
+}
+
+// [=]===^=[ x11_sync ]===========================================================================[=]
+// XSync, deferred to mkfw_commit_batch while a batch is open.
+static void x11_sync(struct mkfw_context *ctx) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	if(xc->batch_depth) {
+		xc->batch_sync = 1;
+		return;
+	}
+	x11_round_trips(ctx, 1);
+	XSync(xc->display, False);
+}
+
+// [=]===^=[ mkfw_begin_batch ]===================================================================[=]
+MKFW_API void mkfw_begin_batch(struct mkfw_context *ctx) {
+	if(!ctx) {
+		return;
+	}
+	++CTX_PLATFORM(ctx)->batch_depth;
+}
+
+// [=]===^=[ mkfw_commit_batch ]==================================================================[=]
+// Closing the outermost batch sends everything the setters queued in one
+// flush, or one XSync if any of them wanted to wait for the server.
+MKFW_API void mkfw_commit_batch(struct mkfw_context *ctx) {
+	if(!ctx || !CTX_PLATFORM(ctx)->batch_depth) {
+		return;
+	}
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	if(--xc->batch_depth) {
+		return;
+	}
+	if(xc->batch_sync) {
+		xc->batch_sync = 0;
+		x11_sync(ctx);
+	} else {
+		XFlush(xc->display);
+	}
+}
+
 struct mkfw_cursor {
 	Cursor x_cursor;
 };
@@ -134,6 +481,7 @@ struct x11_mkfw_window {
 	uint8_t cursor_visible;
 	int32_t last_mouse_x;
 	int32_t last_mouse_y;
+	uint8_t warp_pending;    // recentre the locked cursor at the end of this pump
 	int32_t win_saved_width;
 	int32_t win_saved_height;
 	int32_t win_saved_x;
@@ -149,12 +497,26 @@ struct x11_mkfw_window {
 	int32_t max_height;
 	int32_t aspect_num;
 	int32_t aspect_den;
-	Atom wm_delete_window;
-	Cursor hidden_cursor;
 	uint8_t should_close;
 	uint8_t in_window;
 	int32_t xi_opcode;
 
+	// Core event mask currently selected on the window; see
+	// x11_window_event_mask.  delta_polled latches once the polling getter
+	// is used, since no callback tells us the caller wants deltas.
+	long event_mask;
+	uint8_t delta_polled;
+
+	// Held modifiers as MKFW_MOD_* bits, and the mask passed to key
+	// callbacks (left/right widened for shift, ctrl and alt); both only
+	// change on modifier key events.
+	uint8_t modifiers;
+	uint32_t key_modifier_bits;
+
+	// X keycodes currently held, one bit each; a KeyPress for a keycode
+	// that is already down is an auto-repeat.
+	uint8_t keys_down[32];
+
 	// Mouse delta smoothing (per-window)
 	double last_mouse_dx;
 	double last_mouse_dy;
@@ -164,6 +526,27 @@ struct x11_mkfw_window {
 	double accumulated_dy;
 	double mouse_sensitivity;
 
+	// Raw motion merged within one pump (MKFW_INIT_COALESCE_MOTION)
+	struct mkfw_delta_accumulator coalesced_delta;
+
+	// Swap timing.  The drawable's swap count carries on across recycling,
+	// so swaps_base (present.swaps at the last recycle) is subtracted from
+	// what the caller sees.
+	struct mkfw_present_stats present;
+	uint64_t swaps_base;
+
+	// One fence per swap while options.frames_in_flight is set; the slot at
+	// fence_head holds the fence from frames_in_flight swaps back.
+	void *fences[MKFW_MAX_FRAMES_IN_FLIGHT];
+	uint32_t fence_head;
+	uint8_t has_sync;   // the window's context has GL 3.2 or ARB_sync
+
+	// Swap interval the caller asked for and the one on the drawable; they
+	// differ while mkfw_present_windows swaps the window unthrottled.
+	int32_t swap_interval;
+	int32_t swap_interval_applied;
+	uint8_t swap_interval_known;
+
 	// Framebuffer size tracking (per-window)
 	int32_t last_framebuffer_width;
 	int32_t last_framebuffer_height;
@@ -176,44 +559,35 @@ struct x11_mkfw_window {
 	// Last reported content scale, for the content-scale callback
 	float last_content_scale;
 
-	// XIM for Unicode text input
-	XIM xim;
+	// Input context for Unicode text input; created on the context's XIM
+	// once the window wants characters (x11_window_update_xic).
 	XIC xic;
 
-	// Cursor shapes
-	Cursor cursors[MKFW_CURSOR_LAST];
+	// Cursor shape; the Cursors themselves belong to the context.
 	uint32_t current_cursor;
 	Cursor active_custom_cursor;
 
 	// Clipboard
-	Atom clipboard_atom;
-	Atom utf8_string_atom;
-	Atom targets_atom;
-	Atom mkfw_clipboard_atom;
 	char *clipboard_text;
 
 	// XDND drag-and-drop
-	Atom xdnd_aware;
-	Atom xdnd_enter;
-	Atom xdnd_position;
-	Atom xdnd_status;
-	Atom xdnd_leave;
-	Atom xdnd_drop;
-	Atom xdnd_finished;
-	Atom xdnd_selection;
-	Atom xdnd_type_list;
-	Atom text_uri_list;
 	Window xdnd_source;
 	uint8_t xdnd_has_uri_list;
 
-	// Window state callback tracking
-	Atom net_wm_state;
-	Atom net_wm_state_maximized_horz;
-	Atom net_wm_state_maximized_vert;
-	Atom wm_state;
-	Atom net_wm_state_demands_attention;
-	uint8_t last_maximized;
-	uint8_t last_minimized;
+	// Geometry and WM state mirrored from the event stream so the getters
+	// never wait on the server.
+	int32_t cached_width;
+	int32_t cached_height;
+	int32_t cached_x;
+	int32_t cached_y;
+	uint8_t have_cached_pos;
+	uint8_t reparented;         // parent is a WM frame rather than the root
+	uint8_t cached_minimized;
+	uint8_t cached_maximized;
+
+	// Options the window was last handed out with (title and class name
+	// cleared); matched against new requests when it sits in the pool.
+	struct mkfw_window_options options;
 };
 
 // USB HID Usage Page 7 scancode for each evdev key code (X11 keycode minus 8,
@@ -251,153 +625,224 @@ static const uint8_t mkfw_evdev_to_hid[128] = {
 	[125] = 0xe3, [126] = 0xe7, [127] = 0x65,                        // LSuper RSuper Menu
 };
 
-// [=]===^=[ x11_update_scancode ]================================================================[=]
-static void x11_update_scancode(struct mkfw_window *state, uint32_t keycode, uint32_t down) {
-	if(keycode < 8) {
-		return;
+// [=]===^=[ x11_keysym_to_key ]==================================================================[=]
+static uint32_t x11_keysym_to_key(KeySym keysym) {
+	if(keysym >= XK_0 && keysym <= XK_9) {
+		return MKFW_KEY_0 + (keysym - XK_0);
 	}
-	uint32_t evdev = keycode - 8;
-	if(evdev >= 128) {
-		return;
+	if(keysym >= 0x20 && keysym <= 0x7E) {
+		return (uint32_t)keysym;
 	}
-	uint8_t hid = mkfw_evdev_to_hid[evdev];
-	if(hid) {
-		state->scancode_state[hid] = down ? 1 : 0;
+
+	switch(keysym) {
+		case XK_Escape:    return MKFW_KEY_ESCAPE;
+		case XK_BackSpace: return MKFW_KEY_BACKSPACE;
+		case XK_Tab:       return MKFW_KEY_TAB;
+		case XK_Return:    return MKFW_KEY_RETURN;
+		case XK_Caps_Lock: return MKFW_KEY_CAPSLOCK;
+		case XK_F1:        return MKFW_KEY_F1;
+		case XK_F2:        return MKFW_KEY_F2;
+		case XK_F3:        return MKFW_KEY_F3;
+		case XK_F4:        return MKFW_KEY_F4;
+		case XK_F5:        return MKFW_KEY_F5;
+		case XK_F6:        return MKFW_KEY_F6;
+		case XK_F7:        return MKFW_KEY_F7;
+		case XK_F8:        return MKFW_KEY_F8;
+		case XK_F9:        return MKFW_KEY_F9;
+		case XK_F10:       return MKFW_KEY_F10;
+		case XK_F11:       return MKFW_KEY_F11;
+		case XK_F12:       return MKFW_KEY_F12;
+
+		case XK_Left:      return MKFW_KEY_LEFT;
+		case XK_Right:     return MKFW_KEY_RIGHT;
+		case XK_Up:        return MKFW_KEY_UP;
+		case XK_Down:      return MKFW_KEY_DOWN;
+		case XK_Insert:    return MKFW_KEY_INSERT;
+		case XK_Delete:    return MKFW_KEY_DELETE;
+		case XK_Home:      return MKFW_KEY_HOME;
+		case XK_End:       return MKFW_KEY_END;
+		case XK_Page_Up:   return MKFW_KEY_PAGEUP;
+		case XK_Page_Down: return MKFW_KEY_PAGEDOWN;
+		case XK_Num_Lock:  return MKFW_KEY_NUMLOCK;
+		case XK_Scroll_Lock: return MKFW_KEY_SCROLLLOCK;
+		case XK_Print:     return MKFW_KEY_PRINTSCREEN;
+		case XK_Pause:     return MKFW_KEY_PAUSE;
+		case XK_Menu:      return MKFW_KEY_MENU;
+
+		case XK_KP_0:        return MKFW_KEY_NUMPAD_0;
+		case XK_KP_1:        return MKFW_KEY_NUMPAD_1;
+		case XK_KP_2:        return MKFW_KEY_NUMPAD_2;
+		case XK_KP_3:        return MKFW_KEY_NUMPAD_3;
+		case XK_KP_4:        return MKFW_KEY_NUMPAD_4;
+		case XK_KP_5:        return MKFW_KEY_NUMPAD_5;
+		case XK_KP_6:        return MKFW_KEY_NUMPAD_6;
+		case XK_KP_7:        return MKFW_KEY_NUMPAD_7;
+		case XK_KP_8:        return MKFW_KEY_NUMPAD_8;
+		case XK_KP_9:        return MKFW_KEY_NUMPAD_9;
+		case XK_KP_Decimal:  return MKFW_KEY_NUMPAD_DECIMAL;
+		case XK_KP_Divide:   return MKFW_KEY_NUMPAD_DIVIDE;
+		case XK_KP_Multiply: return MKFW_KEY_NUMPAD_MULTIPLY;
+		case XK_KP_Subtract: return MKFW_KEY_NUMPAD_SUBTRACT;
+		case XK_KP_Add:      return MKFW_KEY_NUMPAD_ADD;
+		case XK_KP_Enter:    return MKFW_KEY_NUMPAD_ENTER;
 	}
+	return 0;
 }
 
-// [=]===^=[ map_x11_keysym ]=====================================================================[=]
-static uint32_t map_x11_keysym(struct mkfw_window *state, KeySym keysym, int key_down) {
-	uint32_t keycode = 0;
-
-	// Handle number keys (XK_0 - XK_9)
-	if(keysym >= XK_0 && keysym <= XK_9) {
-		keycode = MKFW_KEY_0 + (keysym - XK_0);
-	} else if(keysym >= 0x20 && keysym <= 0x7E) {
-		keycode = keysym;
+// [=]===^=[ x11_keysym_to_modifier ]=============================================================[=]
+static uint8_t x11_keysym_to_modifier(KeySym keysym) {
+	switch(keysym) {
+		case XK_Shift_L:   return MKFW_MOD_LSHIFT;
+		case XK_Shift_R:   return MKFW_MOD_RSHIFT;
+		case XK_Control_L: return MKFW_MOD_LCTRL;
+		case XK_Control_R: return MKFW_MOD_RCTRL;
+		case XK_Alt_L:     return MKFW_MOD_LALT;
+		case XK_Alt_R:     return MKFW_MOD_RALT;
+		case XK_Super_L:   return MKFW_MOD_LSUPER;
+		case XK_Super_R:   return MKFW_MOD_RSUPER;
 	}
+	return 0;
+}
 
-	// Track modifier state
-	switch(keysym) {
-		case XK_Shift_L:
-			state->keyboard_state[MKFW_KEY_LSHIFT] = key_down;
-			break;
-		case XK_Shift_R:
-			state->keyboard_state[MKFW_KEY_RSHIFT] = key_down;
-			break;
-		case XK_Control_L:
-			state->keyboard_state[MKFW_KEY_LCTRL] = key_down;
-			break;
-		case XK_Control_R:
-			state->keyboard_state[MKFW_KEY_RCTRL] = key_down;
-			break;
-		case XK_Alt_L:
-			state->keyboard_state[MKFW_KEY_LALT] = key_down;
-			break;
-		case XK_Alt_R:
-			state->keyboard_state[MKFW_KEY_RALT] = key_down;
-			break;
-		case XK_Super_L:
-			state->keyboard_state[MKFW_KEY_LSUPER] = key_down;
-			break;
-		case XK_Super_R:
-			state->keyboard_state[MKFW_KEY_RSUPER] = key_down;
-			break;
+// keyboard_state index for each MKFW_MOD_* bit, lowest bit first.
+static const uint8_t mkfw_modifier_keys[8] = {
+	MKFW_KEY_LSHIFT, MKFW_KEY_RSHIFT, MKFW_KEY_LCTRL, MKFW_KEY_RCTRL,
+	MKFW_KEY_LALT,   MKFW_KEY_RALT,   MKFW_KEY_LSUPER, MKFW_KEY_RSUPER,
+};
+
+// [=]===^=[ x11_build_keymap ]===================================================================[=]
+// Fetches the core keyboard mapping once and resolves every keycode.  The
+// first keysym of a keycode is what XLookupKeysym(event, 0) would return.
+static void x11_build_keymap(struct mkfw_context *ctx) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	memset(xc->keymap, 0, sizeof(xc->keymap));
+
+	int min_keycode = 0, max_keycode = 0, per = 0;
+	XDisplayKeycodes(xc->display, &min_keycode, &max_keycode);
+	if(min_keycode < 8) {
+		min_keycode = 8;
+	}
+	if(max_keycode > 255) {
+		max_keycode = 255;
+	}
+	if(max_keycode < min_keycode) {
+		return;
+	}
+	x11_round_trips(ctx, 1);
+	KeySym *syms = XGetKeyboardMapping(xc->display, (KeyCode)min_keycode, max_keycode - min_keycode + 1, &per);
+	if(!syms) {
+		mkfw_error("keyboard mapping unavailable");
+		return;
 	}
 
-	// Update combined modifier states from keyboard_state
-	state->keyboard_state[MKFW_KEY_SHIFT] = state->keyboard_state[MKFW_KEY_LSHIFT] || state->keyboard_state[MKFW_KEY_RSHIFT];
-	state->keyboard_state[MKFW_KEY_CTRL]  = state->keyboard_state[MKFW_KEY_LCTRL] || state->keyboard_state[MKFW_KEY_RCTRL];
-	state->keyboard_state[MKFW_KEY_ALT]   = state->keyboard_state[MKFW_KEY_LALT] || state->keyboard_state[MKFW_KEY_RALT];
+	for(int kc = min_keycode; kc <= max_keycode; ++kc) {
+		struct x11_keymap_entry *e = &xc->keymap[kc];
+		KeySym keysym = per > 0 ? syms[(kc - min_keycode) * per] : NoSymbol;
+		uint32_t evdev = (uint32_t)kc - 8;
+		e->scancode = evdev < 128 ? mkfw_evdev_to_hid[evdev] : 0;
+		e->modifier = x11_keysym_to_modifier(keysym);
+		e->key = (uint16_t)x11_keysym_to_key(keysym);
+	}
+	XFree(syms);
+}
 
-	// Handle non-extended special keys
-	switch(keysym) {
-		case XK_Escape:    keycode = MKFW_KEY_ESCAPE; break;
-		case XK_BackSpace: keycode = MKFW_KEY_BACKSPACE; break;
-		case XK_Tab:       keycode = MKFW_KEY_TAB; break;
-		case XK_Return:    keycode = MKFW_KEY_RETURN; break;
-		case XK_Caps_Lock: keycode = MKFW_KEY_CAPSLOCK; break;
-		case XK_F1:        keycode = MKFW_KEY_F1; break;
-		case XK_F2:        keycode = MKFW_KEY_F2; break;
-		case XK_F3:        keycode = MKFW_KEY_F3; break;
-		case XK_F4:        keycode = MKFW_KEY_F4; break;
-		case XK_F5:        keycode = MKFW_KEY_F5; break;
-		case XK_F6:        keycode = MKFW_KEY_F6; break;
-		case XK_F7:        keycode = MKFW_KEY_F7; break;
-		case XK_F8:        keycode = MKFW_KEY_F8; break;
-		case XK_F9:        keycode = MKFW_KEY_F9; break;
-		case XK_F10:       keycode = MKFW_KEY_F10; break;
-		case XK_F11:       keycode = MKFW_KEY_F11; break;
-		case XK_F12:       keycode = MKFW_KEY_F12; break;
-	}
-
-	// Handle extended keys
-	switch(keysym) {
-		case XK_Left:      keycode = MKFW_KEY_LEFT; break;
-		case XK_Right:     keycode = MKFW_KEY_RIGHT; break;
-		case XK_Up:        keycode = MKFW_KEY_UP; break;
-		case XK_Down:      keycode = MKFW_KEY_DOWN; break;
-		case XK_Insert:    keycode = MKFW_KEY_INSERT; break;
-		case XK_Delete:    keycode = MKFW_KEY_DELETE; break;
-		case XK_Home:      keycode = MKFW_KEY_HOME; break;
-		case XK_End:       keycode = MKFW_KEY_END; break;
-		case XK_Page_Up:   keycode = MKFW_KEY_PAGEUP; break;
-		case XK_Page_Down: keycode = MKFW_KEY_PAGEDOWN; break;
-		case XK_Num_Lock:  keycode = MKFW_KEY_NUMLOCK; break;
-		case XK_Scroll_Lock: keycode = MKFW_KEY_SCROLLLOCK; break;
-		case XK_Print:     keycode = MKFW_KEY_PRINTSCREEN; break;
-		case XK_Pause:     keycode = MKFW_KEY_PAUSE; break;
-		case XK_Menu:      keycode = MKFW_KEY_MENU; break;
-	}
-
-	// Handle numpad keys
-	switch(keysym) {
-		case XK_KP_0:        keycode = MKFW_KEY_NUMPAD_0; break;
-		case XK_KP_1:        keycode = MKFW_KEY_NUMPAD_1; break;
-		case XK_KP_2:        keycode = MKFW_KEY_NUMPAD_2; break;
-		case XK_KP_3:        keycode = MKFW_KEY_NUMPAD_3; break;
-		case XK_KP_4:        keycode = MKFW_KEY_NUMPAD_4; break;
-		case XK_KP_5:        keycode = MKFW_KEY_NUMPAD_5; break;
-		case XK_KP_6:        keycode = MKFW_KEY_NUMPAD_6; break;
-		case XK_KP_7:        keycode = MKFW_KEY_NUMPAD_7; break;
-		case XK_KP_8:        keycode = MKFW_KEY_NUMPAD_8; break;
-		case XK_KP_9:        keycode = MKFW_KEY_NUMPAD_9; break;
-		case XK_KP_Decimal:  keycode = MKFW_KEY_NUMPAD_DECIMAL; break;
-		case XK_KP_Divide:   keycode = MKFW_KEY_NUMPAD_DIVIDE; break;
-		case XK_KP_Multiply: keycode = MKFW_KEY_NUMPAD_MULTIPLY; break;
-		case XK_KP_Subtract: keycode = MKFW_KEY_NUMPAD_SUBTRACT; break;
-		case XK_KP_Add:      keycode = MKFW_KEY_NUMPAD_ADD; break;
-		case XK_KP_Enter:    keycode = MKFW_KEY_NUMPAD_ENTER; break;
+// [=]===^=[ x11_handle_key ]=====================================================================[=]
+// Key press / release: one table load, then state updates.  Modifier keys
+// update keyboard_state and the modifier masks but, as before, fire no key
+// callback of their own.  Auto-repeats only fire MKFW_REPEAT; they leave
+// keyboard_state and scancode_state alone so edge detection stays clean.
+static void x11_handle_key(struct mkfw_window *state, uint32_t xkeycode, uint8_t key_down, uint64_t time) {
+	struct x11_keymap_entry *e = &WIN_CTX_PLATFORM(state)->keymap[xkeycode & 0xff];
+
+	uint8_t *down = &PLATFORM(state)->keys_down[(xkeycode & 0xff) >> 3];
+	uint8_t bit = (uint8_t)(1u << (xkeycode & 7));
+	if(key_down && (*down & bit)) {
+		if(e->key && !e->modifier) {
+			mkfw_emit_key(state, time, e->key, MKFW_REPEAT, PLATFORM(state)->key_modifier_bits);
+		}
+		return;
 	}
+	*down = key_down ? (*down | bit) : (*down & ~bit);
 
-	// Update key state
-	if(keycode) {
-		state->keyboard_state[keycode] = key_down;
+	if(e->scancode) {
+		state->scancode_state[e->scancode] = key_down;
 	}
 
-	// Call the key callback
-	if(keycode && state->key_callback) {
-		state->key_callback(state, keycode, key_down ? MKFW_PRESSED : MKFW_RELEASED, (state->keyboard_state[MKFW_KEY_SHIFT] ? MKFW_MOD_SHIFT : 0) | (state->keyboard_state[MKFW_KEY_CTRL] ? MKFW_MOD_CTRL : 0) | (state->keyboard_state[MKFW_KEY_ALT] ? MKFW_MOD_ALT : 0) | (state->keyboard_state[MKFW_KEY_LSUPER] ? MKFW_MOD_LSUPER : 0) | (state->keyboard_state[MKFW_KEY_RSUPER] ? MKFW_MOD_RSUPER : 0));
+	if(e->modifier) {
+		uint8_t mods = PLATFORM(state)->modifiers;
+		mods = key_down ? (mods | e->modifier) : (mods & ~e->modifier);
+		PLATFORM(state)->modifiers = mods;
+		state->keyboard_state[mkfw_modifier_keys[__builtin_ctz(e->modifier)]] = key_down;
+		state->keyboard_state[MKFW_KEY_SHIFT] = (mods & MKFW_MOD_SHIFT) != 0;
+		state->keyboard_state[MKFW_KEY_CTRL]  = (mods & MKFW_MOD_CTRL) != 0;
+		state->keyboard_state[MKFW_KEY_ALT]   = (mods & MKFW_MOD_ALT) != 0;
+		PLATFORM(state)->key_modifier_bits = ((mods & MKFW_MOD_SHIFT) ? MKFW_MOD_SHIFT : 0) | ((mods & MKFW_MOD_CTRL) ? MKFW_MOD_CTRL : 0) | ((mods & MKFW_MOD_ALT) ? MKFW_MOD_ALT : 0) | (mods & MKFW_MOD_SUPER);
+		return;
 	}
 
-	return keycode;
+	if(e->key) {
+		state->keyboard_state[e->key] = key_down;
+		mkfw_emit_key(state, time, e->key, key_down ? MKFW_PRESSED : MKFW_RELEASED, PLATFORM(state)->key_modifier_bits);
+	}
 }
 
-// [=]===^=[ enable_xi2_raw_input ]===============================================================[=]
-static void enable_xi2_raw_input(struct mkfw_window *state) {
+// [=]===^=[ x11_query_xi2 ]=====================================================================[=]
+static void x11_query_xi2(struct mkfw_context *ctx) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
 	int event, error;
-	if(!XQueryExtension(PLATFORM(state)->display, "XInputExtension", &PLATFORM(state)->xi_opcode, &event, &error)) {
+	xc->xi_opcode = -1;
+	x11_round_trips(ctx, 2);
+	if(!XQueryExtension(xc->display, "XInputExtension", &xc->xi_opcode, &event, &error)) {
+		xc->xi_opcode = -1;
 		mkfw_error("XInput2 not available on this X server");
 		return;
 	}
 
 	int major = 2, minor = 0;
-	if(XIQueryVersion(PLATFORM(state)->display, &major, &minor) == BadRequest) {
+	if(XIQueryVersion(xc->display, &major, &minor) == BadRequest) {
+		xc->xi_opcode = -1;
 		mkfw_error("XInput2 version 2.0 not supported");
+	}
+}
+
+// [=]===^=[ x11_window_event_mask ]==============================================================[=]
+// Core events the window needs right now.  Keys, buttons, motion,
+// crossing, focus, structure and property changes feed the polled state
+// (mouse_x / mouse_y included) and cached getters and are always selected;
+// expose only with a refresh callback.  Core motion only arrives while
+// the pointer is over the window, so it costs nothing while idle.
+static long x11_window_event_mask(struct mkfw_window *state) {
+	long mask = KeyPressMask | KeyReleaseMask | ButtonPressMask | ButtonReleaseMask | PointerMotionMask | StructureNotifyMask | EnterWindowMask | LeaveWindowMask | FocusChangeMask | PropertyChangeMask;
+	if(state->window_refresh_callback) {
+		mask |= ExposureMask;
+	}
+	return mask;
+}
+
+// [=]===^=[ x11_window_wants_raw_motion ]========================================================[=]
+static uint8_t x11_window_wants_raw_motion(struct mkfw_window *state) {
+	if(!state->has_focus && !PLATFORM(state)->cursor_locked) {
+		return 0;
+	}
+	return state->mouse_move_delta_callback || state->mouse_move_delta_timed_callback || state->context->event_queue.events || PLATFORM(state)->cursor_locked || PLATFORM(state)->delta_polled;
+}
+
+// [=]===^=[ x11_update_raw_motion ]==============================================================[=]
+// Select or deselect XI_RawMotion on the root window when the answer
+// changes.  Called on focus changes, cursor lock, and callback changes.
+static void x11_update_raw_motion(struct mkfw_context *ctx) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	if(xc->xi_opcode < 0) {
 		return;
 	}
 
-	Window root = DefaultRootWindow(PLATFORM(state)->display);
+	uint8_t want = 0;
+	for(uint32_t i = 0; i < ctx->window_count && !want; ++i) {
+		want = x11_window_wants_raw_motion(ctx->windows[i]);
+	}
+	if(want == xc->raw_motion_selected) {
+		return;
+	}
 
 	XIEventMask mask;
 	unsigned char mask_bytes[(XI_LASTEVENT + 7) / 8] = {0};
@@ -405,10 +850,168 @@ static void enable_xi2_raw_input(struct mkfw_window *state) {
 	mask.deviceid = XIAllDevices;
 	mask.mask_len = sizeof(mask_bytes);
 	mask.mask = mask_bytes;
-	XISetMask(mask.mask, XI_RawMotion);
+	if(want) {
+		XISetMask(mask.mask, XI_RawMotion);
+	}
 
-	XISelectEvents(PLATFORM(state)->display, root, &mask, 1);
-	XFlush(PLATFORM(state)->display);
+	XISelectEvents(xc->display, DefaultRootWindow(xc->display), &mask, 1);
+	x11_flush(ctx);
+	xc->raw_motion_selected = want;
+}
+
+// [=]===^=[ x11_window_update_xic ]==============================================================[=]
+// Windows only need an input context once something consumes characters;
+// the first one also opens the context's XIM.  Without an XIM the key
+// path falls back to XLookupString.
+static void x11_window_update_xic(struct mkfw_window *state) {
+	if(PLATFORM(state)->xic || (!state->char_callback && !state->context->event_queue.events)) {
+		return;
+	}
+	struct x11_mkfw_context *xc = WIN_CTX_PLATFORM(state);
+	if(!xc->xim_opened) {
+		xc->xim_opened = 1;
+		x11_round_trips(state->context, 1);
+		xc->xim = XOpenIM(xc->display, 0, 0, 0);
+	}
+	if(!xc->xim) {
+		return;
+	}
+	PLATFORM(state)->xic = XCreateIC(xc->xim, XNInputStyle, XIMPreeditNothing | XIMStatusNothing, XNClientWindow, PLATFORM(state)->window, XNFocusWindow, PLATFORM(state)->window, (char *)0);
+	if(PLATFORM(state)->xic && state->has_focus) {
+		XSetICFocus(PLATFORM(state)->xic);
+	}
+}
+
+// [=]===^=[ mkfw_window_update_event_mask ]======================================================[=]
+// Reselect the window's core events and the context's raw motion after a
+// callback, the cursor lock or a polling getter changed what is consumed,
+// and create the input context once characters are wanted.  XSelectInput
+// replaces the mask without a reply, so this costs no round trip.
+MKFW_API void mkfw_window_update_event_mask(struct mkfw_window *state) {
+	X11_CHECK_THREAD(state->context);
+	long mask = x11_window_event_mask(state);
+	if(mask != PLATFORM(state)->event_mask) {
+		PLATFORM(state)->event_mask = mask;
+		XSelectInput(PLATFORM(state)->display, PLATFORM(state)->window, mask);
+		x11_flush(state->context);
+	}
+	x11_window_update_xic(state);
+	x11_update_raw_motion(state->context);
+}
+
+// [=]===^=[ x11_raw_motion_delta ]===============================================================[=]
+// Valuators 0 and 1 of a raw event are the unaccelerated x / y motion;
+// raw_values holds only the valuators set in the mask, in order.
+static void x11_raw_motion_delta(XIRawEvent *re, double *dx, double *dy) {
+	*dx = 0.0;
+	*dy = 0.0;
+	int idx = 0;
+	int nValuators = re->valuators.mask_len * 8;
+	for(int i = 0; i < nValuators && i < 2; i++) {
+		if(XIMaskIsSet(re->valuators.mask, i)) {
+			double val = re->raw_values[idx++];
+
+			if(i == 0) { *dx = val; }
+			if(i == 1) { *dy = val; }
+		}
+	}
+}
+
+// [=]===^=[ x11_window_map_hash ]================================================================[=]
+static uint32_t x11_window_map_hash(Window xid, uint32_t mask) {
+	return ((uint32_t)xid * 2654435761u) & mask;
+}
+
+// [=]===^=[ x11_window_map_put ]=================================================================[=]
+static void x11_window_map_put(struct x11_window_slot *map, uint32_t mask, Window xid, struct mkfw_window *window) {
+	uint32_t i = x11_window_map_hash(xid, mask);
+	while(map[i].xid != None && map[i].xid != xid) {
+		i = (i + 1) & mask;
+	}
+	map[i].xid = xid;
+	map[i].window = window;
+}
+
+// [=]===^=[ x11_window_map_reserve ]=============================================================[=]
+// Make room for one more window, doubling and rehashing the table before
+// it passes half full.  Returns 0 if it could not grow.
+static uint32_t x11_window_map_reserve(struct mkfw_context *ctx) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	uint32_t size = xc->window_map ? xc->window_map_mask + 1 : 0;
+	if((xc->window_map_count + 1) * 2 <= size) {
+		return 1;
+	}
+	uint32_t new_size = size ? size * 2 : MKFW_X11_WINDOW_MAP_SIZE;
+	struct x11_window_slot *map = (struct x11_window_slot *)calloc(new_size, sizeof(struct x11_window_slot));
+	if(!map) {
+		mkfw_error("mkfw_window_create: out of memory growing the window table to %u", new_size);
+		return 0;
+	}
+	for(uint32_t i = 0; i < size; ++i) {
+		if(xc->window_map[i].xid != None) {
+			x11_window_map_put(map, new_size - 1, xc->window_map[i].xid, xc->window_map[i].window);
+		}
+	}
+	free(xc->window_map);
+	xc->window_map = map;
+	xc->window_map_mask = new_size - 1;
+	return 1;
+}
+
+// [=]===^=[ x11_window_map_insert ]==============================================================[=]
+// x11_window_map_reserve first.
+static void x11_window_map_insert(struct mkfw_context *ctx, Window xid, struct mkfw_window *window) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	x11_window_map_put(xc->window_map, xc->window_map_mask, xid, window);
+	++xc->window_map_count;
+}
+
+// [=]===^=[ x11_window_map_remove ]==============================================================[=]
+static void x11_window_map_remove(struct mkfw_context *ctx, Window xid) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	struct x11_window_slot *map = xc->window_map;
+	uint32_t mask = xc->window_map_mask;
+	if(!map) {
+		return;
+	}
+	uint32_t i = x11_window_map_hash(xid, mask);
+	while(map[i].xid != xid) {
+		if(map[i].xid == None) {
+			return;
+		}
+		i = (i + 1) & mask;
+	}
+
+	// Backward-shift deletion: pull later members of the probe chain into
+	// the hole so lookups never need tombstones.
+	uint32_t hole = i;
+	for(uint32_t j = (i + 1) & mask; map[j].xid != None; j = (j + 1) & mask) {
+		uint32_t home = x11_window_map_hash(map[j].xid, mask);
+		if(((j - home) & mask) >= ((j - hole) & mask)) {
+			map[hole] = map[j];
+			hole = j;
+		}
+	}
+	map[hole].xid = None;
+	map[hole].window = 0;
+	--xc->window_map_count;
+}
+
+// [=]===^=[ x11_window_map_find ]================================================================[=]
+static struct mkfw_window *x11_window_map_find(struct mkfw_context *ctx, Window xid) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	struct x11_window_slot *map = xc->window_map;
+	if(!map) {
+		return 0;
+	}
+	uint32_t i = x11_window_map_hash(xid, xc->window_map_mask);
+	while(map[i].xid != None) {
+		if(map[i].xid == xid) {
+			return map[i].window;
+		}
+		i = (i + 1) & xc->window_map_mask;
+	}
+	return 0;
 }
 
 // [=]===^=[ mkfw_window_should_close ]==================================================================[=]
@@ -421,12 +1024,14 @@ MKFW_API void mkfw_window_set_should_close(struct mkfw_window *state, int32_t va
 	PLATFORM(state)->should_close = value;
 }
 
-// [=]===^=[ select_best_fbconfig_for ]===========================================================[=]
-// Returns the chosen GLXFBConfig, or 0 on failure (mkfw_error has been fired).
-// depth_bits / stencil_bits / samples act as hard minimums when nonzero (samples
-// only when > 1); srgb requires an sRGB-capable config when set.  An explicit hint
-// the driver cannot satisfy is a hard failure, never a silent downgrade.
-static GLXFBConfig select_best_fbconfig_for(Display *display, int screen, int32_t transparent, int32_t depth_bits, int32_t stencil_bits, int32_t samples, uint32_t srgb) {
+// [=]===^=[ x11_fbconfig_table_build ]===========================================================[=]
+// Fetch every window-renderable fbconfig and its attributes in one pass.
+// The attribute queries are the expensive part (hundreds of configs on
+// Mesa), so the table is built once per context and only filtered and
+// scored per window.  Returns a malloc'd array, or 0 with *count == 0.
+static struct x11_fbconfig *x11_fbconfig_table_build(Display *display, int screen, uint32_t *count) {
+	*count = 0;
+	x11_need_glx();   // first GLX use; waits for the loader thread if it is still on libGL
 	int fb_count = 0;
 	GLXFBConfig *fbcs = glXChooseFBConfig(display, screen, 0, &fb_count);
 	if(!fbcs || fb_count == 0) {
@@ -437,46 +1042,26 @@ static GLXFBConfig select_best_fbconfig_for(Display *display, int screen, int32_
 		return 0;
 	}
 
-	int32_t want_samples = samples > 1 ? samples : 0;
-	int32_t has_explicit_hint = (depth_bits > 0 || stencil_bits > 0 || want_samples > 0 || srgb);
-
-	GLXFBConfig best_fbconfig = 0;
-	int best_score = 0;
-	int have_best = 0;
+	struct x11_fbconfig *table = (struct x11_fbconfig *)calloc((size_t)fb_count, sizeof(struct x11_fbconfig));
+	if(!table) {
+		mkfw_error("out of memory");
+		XFree(fbcs);
+		return 0;
+	}
 
+	uint32_t n = 0;
 	for(int i = 0; i < fb_count; i++) {
 		int drawable_type = 0;
-		int doublebuffer  = 0;
-		int red_size, green_size, blue_size, alpha_size;
-		int depth_size, stencil_size;
-		int sample_buffers = 0, config_samples = 0, srgb_capable = 0;
-
 		glXGetFBConfigAttrib(display, fbcs[i], GLX_DRAWABLE_TYPE, &drawable_type);
-		glXGetFBConfigAttrib(display, fbcs[i], GLX_DOUBLEBUFFER, &doublebuffer);
 
 		/* Skip configs that cannot render to windows */
 		if(!(drawable_type & GLX_WINDOW_BIT)) {
 			continue;
 		}
 
-		/* Fetch color/depth/stencil sizes */
-		glXGetFBConfigAttrib(display, fbcs[i], GLX_ALPHA_SIZE, &alpha_size);
-		if(transparent && alpha_size < 8) {
-			continue;
-		}
-
-		/* For transparency we need a true 32-bit visual, not just alpha in the fbconfig */
-		if(transparent) {
-			XVisualInfo *tvi = glXGetVisualFromFBConfig(display, fbcs[i]);
-			if(!tvi || tvi->depth != 32) {
-				if(tvi) {
-					XFree(tvi);
-				}
-				continue;
-			}
-			XFree(tvi);
-		}
-
+		int doublebuffer = 0, red_size = 0, green_size = 0, blue_size = 0, alpha_size = 0;
+		int depth_size = 0, stencil_size = 0, sample_buffers = 0, config_samples = 0, srgb_capable = 0;
+		glXGetFBConfigAttrib(display, fbcs[i], GLX_DOUBLEBUFFER, &doublebuffer);
 		glXGetFBConfigAttrib(display, fbcs[i], GLX_RED_SIZE, &red_size);
 		glXGetFBConfigAttrib(display, fbcs[i], GLX_GREEN_SIZE, &green_size);
 		glXGetFBConfigAttrib(display, fbcs[i], GLX_BLUE_SIZE, &blue_size);
@@ -487,17 +1072,196 @@ static GLXFBConfig select_best_fbconfig_for(Display *display, int screen, int32_
 		glXGetFBConfigAttrib(display, fbcs[i], GLX_SAMPLES, &config_samples);
 		glXGetFBConfigAttrib(display, fbcs[i], GLX_FRAMEBUFFER_SRGB_CAPABLE_ARB, &srgb_capable);
 
+		struct x11_fbconfig *c = &table[n++];
+		c->config         = fbcs[i];
+		c->red            = (uint8_t)red_size;
+		c->green          = (uint8_t)green_size;
+		c->blue           = (uint8_t)blue_size;
+		c->alpha          = (uint8_t)alpha_size;
+		c->depth          = (uint8_t)depth_size;
+		c->stencil        = (uint8_t)stencil_size;
+		c->samples        = (uint8_t)config_samples;
+		c->sample_buffers = (uint8_t)sample_buffers;
+		c->doublebuffer   = doublebuffer ? 1 : 0;
+		c->srgb           = srgb_capable ? 1 : 0;
+		c->visual_depth   = -1;
+	}
+
+	// GLXFBConfig handles stay valid after the list itself is freed.
+	XFree(fbcs);
+	if(n == 0) {
+		mkfw_error("no framebuffer config supports window rendering");
+		free(table);
+		return 0;
+	}
+	*count = n;
+	return table;
+}
+
+// [=]===^=[ x11_context_fbconfigs ]==============================================================[=]
+static struct x11_fbconfig *x11_context_fbconfigs(struct mkfw_context *ctx, uint32_t *count) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	if(!xc->fbconfigs_fetched) {
+		xc->fbconfigs_fetched = 1;
+		x11_round_trips(ctx, 1);
+		xc->fbconfigs = x11_fbconfig_table_build(xc->display, DefaultScreen(xc->display), &xc->fbconfig_count);
+	}
+	*count = xc->fbconfig_count;
+	return xc->fbconfigs;
+}
+
+// [=]===^=[ x11_glx_has_extension ]==============================================================[=]
+static uint32_t x11_glx_has_extension(const char *list, const char *name) {
+	size_t len = strlen(name);
+	for(const char *p = list; p && (p = strstr(p, name)); p += len) {
+		if((p == list || p[-1] == ' ') && (p[len] == ' ' || p[len] == 0)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// [=]===^=[ x11_gl_context_has_sync ]============================================================[=]
+// Whether the current context can use fences: GL 3.2 or ARB_sync.
+// glXGetProcAddress answers for any name, so the entry points alone prove
+// nothing.  Core contexts have no GL_EXTENSIONS string; walk glGetStringi.
+static uint32_t x11_gl_context_has_sync(void) {
+	typedef const unsigned char *(*PFNGLGETSTRINGPROC)(unsigned int);
+	typedef const unsigned char *(*PFNGLGETSTRINGIPROC)(unsigned int, unsigned int);
+	typedef void (*PFNGLGETINTEGERVPROC)(unsigned int, int *);
+	PFNGLGETSTRINGPROC pglGetString = (PFNGLGETSTRINGPROC)glXGetProcAddress((const unsigned char *)"glGetString");
+	const char *version = pglGetString ? (const char *)pglGetString(0x1F02) : 0;   // GL_VERSION
+	int32_t major = 0, minor = 0;
+	if(!version || !mkfw_parse_version(version, &major, &minor)) {
+		return 0;
+	}
+	if(major > 3 || (major == 3 && minor >= 2)) {
+		return 1;
+	}
+	const char *exts = (const char *)pglGetString(0x1F03);   // GL_EXTENSIONS
+	if(exts) {
+		return x11_glx_has_extension(exts, "GL_ARB_sync");
+	}
+	PFNGLGETSTRINGIPROC pglGetStringi = (PFNGLGETSTRINGIPROC)glXGetProcAddress((const unsigned char *)"glGetStringi");
+	PFNGLGETINTEGERVPROC pglGetIntegerv = (PFNGLGETINTEGERVPROC)glXGetProcAddress((const unsigned char *)"glGetIntegerv");
+	int count = 0;
+	if(major < 3 || !pglGetStringi || !pglGetIntegerv) {
+		return 0;
+	}
+	pglGetIntegerv(0x821D, &count);   // GL_NUM_EXTENSIONS
+	for(int i = 0; i < count; ++i) {
+		const char *name = (const char *)pglGetStringi(0x1F03, (unsigned int)i);
+		if(name && strcmp(name, "GL_ARB_sync") == 0) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// [=]===^=[ x11_present_resolve ]================================================================[=]
+// Pick the present timing source once per context.  INTEL_swap_event
+// delivers every completed swap through the event queue at no cost;
+// OML_sync_control costs a round trip per sample; otherwise swaps are
+// timed on the CPU.  Also resolves swap control and the fence calls for
+// frames_in_flight; glXGetProcAddress does not need a current context.
+// Whether a context may use the fence calls is x11_gl_context_has_sync.
+static void x11_present_resolve(struct mkfw_context *ctx) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	if(xc->present_resolved) {
+		return;
+	}
+	xc->present_resolved = 1;
+	xc->present_source = MKFW_PRESENT_CPU;
+	xc->glFenceSync      = (PFN_mkfw_glFenceSync)glXGetProcAddress((const unsigned char *)"glFenceSync");
+	xc->glClientWaitSync = (PFN_mkfw_glClientWaitSync)glXGetProcAddress((const unsigned char *)"glClientWaitSync");
+	xc->glDeleteSync     = (PFN_mkfw_glDeleteSync)glXGetProcAddress((const unsigned char *)"glDeleteSync");
+	if(!xc->glFenceSync || !xc->glClientWaitSync || !xc->glDeleteSync) {
+		xc->glFenceSync = 0;
+	}
+
+	PFNGLXQUERYEXTENSIONSSTRINGPROC pglXQueryExtensionsString = (PFNGLXQUERYEXTENSIONSSTRINGPROC)glXGetProcAddress((const unsigned char *)"glXQueryExtensionsString");
+	const char *exts = pglXQueryExtensionsString ? pglXQueryExtensionsString(xc->display, DefaultScreen(xc->display)) : 0;
+
+	// glXGetProcAddress returns a stub for any name, so the extension
+	// string decides.
+	if(x11_glx_has_extension(exts, "GLX_EXT_swap_control")) {
+		xc->glXSwapIntervalEXT = (PFNGLXSWAPINTERVALEXTPROC)glXGetProcAddress((const unsigned char *)"glXSwapIntervalEXT");
+		xc->glXQueryDrawable   = (PFNGLXQUERYDRAWABLEPROC)glXGetProcAddress((const unsigned char *)"glXQueryDrawable");
+	}
+	if(xc->glXSwapIntervalEXT && xc->glXQueryDrawable) {
+		xc->swap_caps = MKFW_SWAP_CAP_INTERVAL;
+		if(x11_glx_has_extension(exts, "GLX_EXT_swap_control_tear")) {
+			xc->swap_caps |= MKFW_SWAP_CAP_TEAR;
+		}
+	} else if(x11_glx_has_extension(exts, "GLX_MESA_swap_control")) {
+		xc->glXSwapIntervalEXT = 0;
+		xc->glXSwapIntervalMESA    = (PFNGLXSWAPINTERVALMESAPROC)glXGetProcAddress((const unsigned char *)"glXSwapIntervalMESA");
+		xc->glXGetSwapIntervalMESA = (PFNGLXGETSWAPINTERVALMESAPROC)glXGetProcAddress((const unsigned char *)"glXGetSwapIntervalMESA");
+		if(xc->glXSwapIntervalMESA && xc->glXGetSwapIntervalMESA) {
+			xc->swap_caps = MKFW_SWAP_CAP_INTERVAL;
+		}
+	}
+	int32_t opcode, error_base;
+	if(x11_glx_has_extension(exts, "GLX_INTEL_swap_event") && XQueryExtension(xc->display, "GLX", &opcode, &xc->glx_event_base, &error_base)) {
+		xc->present_source = MKFW_PRESENT_INTEL;
+	} else if(x11_glx_has_extension(exts, "GLX_OML_sync_control")) {
+		xc->glXGetSyncValuesOML = (PFNGLXGETSYNCVALUESOMLPROC)glXGetProcAddress((const unsigned char *)"glXGetSyncValuesOML");
+		if(xc->glXGetSyncValuesOML) {
+			xc->present_source = MKFW_PRESENT_OML;
+		}
+	}
+}
+
+// [=]===^=[ select_best_fbconfig_for ]===========================================================[=]
+// Returns the chosen GLXFBConfig, or 0 on failure (mkfw_error has been fired).
+// depth_bits / stencil_bits / samples act as hard minimums when nonzero (samples
+// only when > 1); srgb requires an sRGB-capable config when set.  An explicit hint
+// the driver cannot satisfy is a hard failure, never a silent downgrade.
+static GLXFBConfig select_best_fbconfig_for(Display *display, struct x11_fbconfig *table, uint32_t count, int32_t transparent, int32_t depth_bits, int32_t stencil_bits, int32_t samples, uint32_t srgb) {
+	if(!table || count == 0) {
+		return 0;
+	}
+
+	int32_t want_samples = samples > 1 ? samples : 0;
+	int32_t has_explicit_hint = (depth_bits > 0 || stencil_bits > 0 || want_samples > 0 || srgb);
+
+	GLXFBConfig best_fbconfig = 0;
+	int best_score = 0;
+	int have_best = 0;
+
+	for(uint32_t i = 0; i < count; i++) {
+		struct x11_fbconfig *c = &table[i];
+
+		if(transparent && c->alpha < 8) {
+			continue;
+		}
+
+		/* For transparency we need a true 32-bit visual, not just alpha in the fbconfig.
+		 * Looked up on first use and remembered in the table. */
+		if(transparent) {
+			if(c->visual_depth < 0) {
+				XVisualInfo *tvi = glXGetVisualFromFBConfig(display, c->config);
+				c->visual_depth = tvi ? (int8_t)tvi->depth : 0;
+				if(tvi) {
+					XFree(tvi);
+				}
+			}
+			if(c->visual_depth != 32) {
+				continue;
+			}
+		}
+
 		/* Hard minimums: reject configs that cannot meet an explicit request */
-		if(depth_bits > 0 && depth_size < depth_bits) {
+		if(depth_bits > 0 && c->depth < depth_bits) {
 			continue;
 		}
-		if(stencil_bits > 0 && stencil_size < stencil_bits) {
+		if(stencil_bits > 0 && c->stencil < stencil_bits) {
 			continue;
 		}
-		if(want_samples > 0 && (sample_buffers < 1 || config_samples < want_samples)) {
+		if(want_samples > 0 && (c->sample_buffers < 1 || c->samples < want_samples)) {
 			continue;
 		}
-		if(srgb && !srgb_capable) {
+		if(srgb && !c->srgb) {
 			continue;
 		}
 
@@ -505,39 +1269,39 @@ static GLXFBConfig select_best_fbconfig_for(Display *display, int screen, int32_
 		 * terms tune the choice among the qualifying configs. */
 		int score = 0;
 
-		if(doublebuffer) {
+		if(c->doublebuffer) {
 			score += 100;
 		}
 
-		if(red_size >= 8 && green_size >= 8 && blue_size >= 8) {
+		if(c->red >= 8 && c->green >= 8 && c->blue >= 8) {
 			score += 50;
 		}
 
-		if(alpha_size >= 8) {
+		if(c->alpha >= 8) {
 			score += 25;
 		}
 
 		if(depth_bits > 0) {
-			score -= (depth_size - depth_bits);   // prefer the closest at-or-above match
-		} else if(depth_size >= 24) {
+			score -= (c->depth - depth_bits);   // prefer the closest at-or-above match
+		} else if(c->depth >= 24) {
 			score += 10;
 		}
 
 		if(stencil_bits > 0) {
-			score -= (stencil_size - stencil_bits);
-		} else if(stencil_size >= 8) {
+			score -= (c->stencil - stencil_bits);
+		} else if(c->stencil >= 8) {
 			score += 5;
 		}
 
 		if(want_samples > 0) {
-			score -= (config_samples - want_samples); // prefer exact sample count
-		} else if(sample_buffers == 0) {
+			score -= (c->samples - want_samples);    // prefer exact sample count
+		} else if(c->sample_buffers == 0) {
 			score += 20;                              // no MSAA requested: avoid stumbling onto a multisampled config
 		}
 
 		if(!have_best || score > best_score) {
 			best_score = score;
-			best_fbconfig = fbcs[i];
+			best_fbconfig = c->config;
 			have_best = 1;
 		}
 	}
@@ -545,14 +1309,12 @@ static GLXFBConfig select_best_fbconfig_for(Display *display, int screen, int32_
 	if(!have_best) {
 		if(has_explicit_hint) {
 			mkfw_error("no framebuffer config matches requested format (depth>=%d, stencil>=%d, samples>=%d, srgb=%u)", depth_bits, stencil_bits, want_samples, srgb ? 1u : 0u);
-			XFree(fbcs);
 			return 0;
 		}
 		mkfw_error("no suitable framebuffer config supports window rendering, falling back to first");
-		best_fbconfig = fbcs[0];
+		best_fbconfig = table[0].config;
 	}
 
-	XFree(fbcs);
 	return best_fbconfig;
 }
 
@@ -569,38 +1331,25 @@ MKFW_API void mkfw_window_attach_context(struct mkfw_window *state) {
 // [=]===^=[ mkfw_window_show ]===================================================================[=]
 MKFW_API void mkfw_window_show(struct mkfw_window *state) {
 	XMapWindow(PLATFORM(state)->display, PLATFORM(state)->window);
-	XFlush(PLATFORM(state)->display);
-	XSync(PLATFORM(state)->display, 0);
+	x11_sync(state->context);
 }
 
 // [=]===^=[ mkfw_window_hide ]===================================================================[=]
 MKFW_API void mkfw_window_hide(struct mkfw_window *state) {
 	XUnmapWindow(PLATFORM(state)->display, PLATFORM(state)->window);
-	XFlush(PLATFORM(state)->display);
+	x11_flush(state->context);
 }
 
-// [=]===^=[ mkfw_query_max_gl_version ]==========================================================[=]
-MKFW_API uint32_t mkfw_query_max_gl_version(int32_t *major, int32_t *minor) {
-	load_x11_functions();
-	Display *dpy = XOpenDisplay(0);
-	if(!dpy) {
-		mkfw_error("mkfw_query_max_gl_version: unable to open X display");
-		return 0;
-	}
-
-	load_glx_functions(dpy);
-
+// [=]===^=[ x11_probe_gl_context ]===============================================================[=]
+// Create a throwaway 1x1 window and 3.1 compat context on fb_config and
+// parse GL_VERSION.  Whatever context was current on this thread is
+// restored.  Failures come back through *error instead of mkfw_error, so
+// the async probe worker can hand them to the pump.
+static uint32_t x11_probe_gl_context(Display *dpy, GLXFBConfig fb_config, int32_t *major, int32_t *minor, const char **error) {
 	int screen = DefaultScreen(dpy);
-	GLXFBConfig fb_config = select_best_fbconfig_for(dpy, screen, 0, 0, 0, 0, 0);
-	if(!fb_config) {
-		XCloseDisplay(dpy);
-		return 0;
-	}
-
 	XVisualInfo *vi = glXGetVisualFromFBConfig(dpy, fb_config);
 	if(!vi) {
-		mkfw_error("mkfw_query_max_gl_version: glXGetVisualFromFBConfig returned 0");
-		XCloseDisplay(dpy);
+		*error = "glXGetVisualFromFBConfig returned 0";
 		return 0;
 	}
 
@@ -620,14 +1369,15 @@ MKFW_API uint32_t mkfw_query_max_gl_version(int32_t *major, int32_t *minor) {
 
 	GLXContext ctx = glXCreateContextAttribsARB(dpy, fb_config, 0, 1, ctx_attribs);
 	if(!ctx) {
-		mkfw_error("mkfw_query_max_gl_version: glXCreateContextAttribsARB failed to create probe context");
+		*error = "glXCreateContextAttribsARB failed to create probe context";
 		XDestroyWindow(dpy, win);
 		XFreeColormap(dpy, cmap);
 		XFree(vi);
-		XCloseDisplay(dpy);
 		return 0;
 	}
 
+	GLXContext prev_ctx = glXGetCurrentContext ? glXGetCurrentContext() : 0;
+	GLXDrawable prev_drawable = glXGetCurrentDrawable();
 	glXMakeCurrent(dpy, win, ctx);
 
 	typedef const unsigned char *(*PFNGLGETSTRINGPROC)(unsigned int);
@@ -649,16 +1399,140 @@ MKFW_API uint32_t mkfw_query_max_gl_version(int32_t *major, int32_t *minor) {
 		}
 	}
 
-	glXMakeCurrent(dpy, None, 0);
+	glXMakeCurrent(dpy, prev_ctx ? prev_drawable : None, prev_ctx);
 	glXDestroyContext(dpy, ctx);
 	XDestroyWindow(dpy, win);
 	XFreeColormap(dpy, cmap);
 	XFree(vi);
+
+	return result;
+}
+
+// [=]===^=[ x11_probe_gl_version ]===============================================================[=]
+static uint32_t x11_probe_gl_version(Display *dpy, struct x11_fbconfig *fbconfigs, uint32_t fbconfig_count, int32_t *major, int32_t *minor) {
+	GLXFBConfig fb_config = select_best_fbconfig_for(dpy, fbconfigs, fbconfig_count, 0, 0, 0, 0, 0);
+	if(!fb_config) {
+		return 0;
+	}
+	const char *error = 0;
+	uint32_t result = x11_probe_gl_context(dpy, fb_config, major, minor, &error);
+	if(error) {
+		mkfw_error("mkfw_query_max_gl_version: %s", error);
+	}
+	return result;
+}
+
+// [=]===^=[ mkfw_query_max_gl_version ]==========================================================[=]
+MKFW_API uint32_t mkfw_query_max_gl_version(int32_t *major, int32_t *minor) {
+	x11_need_x11();
+	Display *dpy = XOpenDisplay(0);
+	if(!dpy) {
+		mkfw_error("mkfw_query_max_gl_version: unable to open X display");
+		return 0;
+	}
+
+	uint32_t fbconfig_count = 0;
+	struct x11_fbconfig *fbconfigs = x11_fbconfig_table_build(dpy, DefaultScreen(dpy), &fbconfig_count);
+	uint32_t result = x11_probe_gl_version(dpy, fbconfigs, fbconfig_count, major, minor);
+	free(fbconfigs);
 	XCloseDisplay(dpy);
 
 	return result;
 }
 
+// [=]===^=[ x11_gl_cache_key ]===================================================================[=]
+// Identifies the driver stack without a GL context: GLX_MESA_query_renderer
+// vendor id, device id and driver version, plus a hash of the GLX extension
+// string.  The GLX vendor and version strings alone say "SGI" / "1.4" for
+// every Mesa driver, so without query_renderer there is no key and the
+// version is always probed.  Returns 0 when no key can be built.
+static uint32_t x11_gl_cache_key(Display *dpy, char *key, size_t size) {
+	// Runs before any GL window has loaded libGL, possibly while the loader
+	// thread is still at it; pthread_once makes this wait for it.
+	x11_need_glx();
+	if(!glXGetProcAddress) {
+		return 0;
+	}
+	PFNGLXQUERYEXTENSIONSSTRINGPROC pglXQueryExtensionsString = (PFNGLXQUERYEXTENSIONSSTRINGPROC)glXGetProcAddress((const unsigned char *)"glXQueryExtensionsString");
+	int screen = DefaultScreen(dpy);
+	const char *exts = pglXQueryExtensionsString ? pglXQueryExtensionsString(dpy, screen) : 0;
+	if(!exts || !x11_glx_has_extension(exts, "GLX_MESA_query_renderer")) {
+		return 0;
+	}
+	PFNGLXQUERYRENDERERINTEGERMESAPROC pglXQueryRendererIntegerMESA = (PFNGLXQUERYRENDERERINTEGERMESAPROC)glXGetProcAddress((const unsigned char *)"glXQueryRendererIntegerMESA");
+	unsigned int vendor = 0, device = 0, version[3] = {0};
+	if(!pglXQueryRendererIntegerMESA
+	|| !pglXQueryRendererIntegerMESA(dpy, screen, 0, GLX_RENDERER_VENDOR_ID_MESA, &vendor)
+	|| !pglXQueryRendererIntegerMESA(dpy, screen, 0, GLX_RENDERER_DEVICE_ID_MESA, &device)
+	|| !pglXQueryRendererIntegerMESA(dpy, screen, 0, GLX_RENDERER_VERSION_MESA, version)) {
+		return 0;
+	}
+	uint64_t hash = 0xcbf29ce484222325ULL;   // FNV-1a
+	for(const char *p = exts; *p; ++p) {
+		hash = (hash ^ (uint8_t)*p) * 0x100000001b3ULL;
+	}
+	int len = snprintf(key, size, "%04x:%04x|%u.%u.%u|%016llx", vendor, device, version[0], version[1], version[2], (unsigned long long)hash);
+	return len > 0 && (size_t)len < size;
+}
+
+// [=]===^=[ x11_gl_cache_read ]==================================================================[=]
+// Cache file format: the key on the first line, "major minor" on the
+// second.  One entry; a driver change simply rewrites it.
+static uint32_t x11_gl_cache_read(const char *path, const char *key, int32_t *major, int32_t *minor) {
+	FILE *f = fopen(path, "r");
+	if(!f) {
+		return 0;
+	}
+	char line[512];
+	uint32_t result = 0;
+	if(fgets(line, sizeof(line), f)) {
+		line[strcspn(line, "\n")] = 0;
+		if(strcmp(line, key) == 0 && fscanf(f, "%d %d", major, minor) == 2 && *major > 0) {
+			result = 1;
+		}
+	}
+	fclose(f);
+	return result;
+}
+
+// [=]===^=[ x11_gl_cache_write ]=================================================================[=]
+static void x11_gl_cache_write(const char *path, const char *key, int32_t major, int32_t minor) {
+	FILE *f = fopen(path, "w");
+	if(!f) {
+		return;
+	}
+	fprintf(f, "%s\n%d %d\n", key, major, minor);
+	fclose(f);
+}
+
+// [=]===^=[ x11_context_gl_version ]=============================================================[=]
+// Driver maximum GL version for this context: probed at most once on the
+// context's own connection, and not at all when the persistent cache
+// matches the current driver stack.
+static uint32_t x11_context_gl_version(struct mkfw_context *ctx, int32_t *major, int32_t *minor) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	if(!xc->gl_probed) {
+		xc->gl_probed = 1;
+		char key[512];
+		uint32_t have_key = xc->gl_version_cache && x11_gl_cache_key(xc->display, key, sizeof(key));
+		xc->gl_from_cache = have_key && x11_gl_cache_read(xc->gl_version_cache, key, &xc->gl_max_major, &xc->gl_max_minor);
+		if(!xc->gl_from_cache) {
+			x11_round_trips(ctx, 3);
+			uint32_t fbconfig_count = 0;
+			struct x11_fbconfig *fbconfigs = x11_context_fbconfigs(ctx, &fbconfig_count);
+			if(x11_probe_gl_version(xc->display, fbconfigs, fbconfig_count, &xc->gl_max_major, &xc->gl_max_minor) && have_key) {
+				x11_gl_cache_write(xc->gl_version_cache, key, xc->gl_max_major, xc->gl_max_minor);
+			}
+		}
+	}
+	if(xc->gl_max_major <= 0) {
+		return 0;
+	}
+	*major = xc->gl_max_major;
+	*minor = xc->gl_max_minor;
+	return 1;
+}
+
 // Forward declaration for monitor query used inside mkfw_init
 static int32_t mkfw_query_monitors_into(struct mkfw_context *ctx);
 
@@ -694,44 +1568,353 @@ static float mkfw_compute_content_scale(Display *dpy) {
 	return 1.0f;
 }
 
+// [=]===^=[ x11_calibrate_server_time ]===========================================================[=]
+// Pairs an X server timestamp with the local monotonic clock: a zero-length
+// property append on a throwaway InputOnly window makes the server stamp a
+// PropertyNotify with its current time, bracketed by two local reads.
+static void x11_calibrate_server_time(struct mkfw_context *ctx) {
+	Display *dpy = CTX_PLATFORM(ctx)->display;
+	XSetWindowAttributes swa;
+	swa.event_mask = PropertyChangeMask;
+	Window probe = XCreateWindow(dpy, DefaultRootWindow(dpy), 0, 0, 1, 1, 0, 0, InputOnly, 0, CWEventMask, &swa);
+
+	uint64_t before = mkfw_get_time();
+	XChangeProperty(dpy, probe, XA_WM_NAME, XA_STRING, 8, PropModeAppend, (const unsigned char *)"", 0);
+	XEvent ev;
+	XWindowEvent(dpy, probe, PropertyChangeMask, &ev);
+	uint64_t after = mkfw_get_time();
+
+	CTX_PLATFORM(ctx)->server_clock.ref    = ev.xproperty.time;
+	CTX_PLATFORM(ctx)->server_clock.ref_ns = before + (after - before) / 2;
+	XDestroyWindow(dpy, probe);
+}
+
+// [=]===^=[ x11_server_clock_to_ns ]=============================================================[=]
+// Converts an event timestamp to mkfw_get_time() nanoseconds.  The signed
+// 32-bit difference handles wraparound; the reference is advanced as time
+// moves on so the difference never nears its range.  Synthetic events carry
+// CurrentTime (0) and are stamped on arrival instead.
+static uint64_t x11_server_clock_to_ns(struct x11_server_clock *clock, Time t) {
+	if(t == CurrentTime) {
+		return mkfw_get_time();
+	}
+	int32_t delta_ms = (int32_t)(uint32_t)(t - clock->ref);
+	uint64_t ns = clock->ref_ns + (int64_t)delta_ms * 1000000;
+	if(delta_ms > (1 << 30)) {
+		clock->ref = t;
+		clock->ref_ns = ns;
+	}
+	return ns;
+}
+
+// [=]===^=[ x11_server_time_to_ns ]==============================================================[=]
+static uint64_t x11_server_time_to_ns(struct mkfw_context *ctx, Time t) {
+	return x11_server_clock_to_ns(&CTX_PLATFORM(ctx)->server_clock, t);
+}
+
+// [=]===^=[ x11_input_thread_flush_motion ]======================================================[=]
+static void x11_input_thread_flush_motion(struct mkfw_context *ctx, struct mkfw_delta_accumulator *motion) {
+	int32_t dx, dy;
+	if(mkfw_delta_take(motion, &dx, &dy)) {
+		MKFW_EVENT_INIT(ev, 0, MKFW_EVENT_MOUSE_DELTA, motion->time);
+		ev.delta.dx = dx;
+		ev.delta.dy = dy;
+		mkfw_event_ring_push(&ctx->raw_input, &ev);
+	}
+}
+
+// [=]===^=[ x11_input_thread_button ]============================================================[=]
+static void x11_input_thread_button(struct mkfw_context *ctx, uint32_t xbtn, uint32_t pressed, uint64_t time) {
+	uint8_t mapped = 0;
+	if(xbtn >= 4 && xbtn <= 7) {
+		if(!pressed) {
+			return;
+		}
+		MKFW_EVENT_INIT(ev, 0, MKFW_EVENT_SCROLL, time);
+		ev.scroll.x = (xbtn == 6) ? -1.0 : (xbtn == 7) ? 1.0 : 0.0;
+		ev.scroll.y = (xbtn == 4) ?  1.0 : (xbtn == 5) ? -1.0 : 0.0;
+		mkfw_event_ring_push(&ctx->raw_input, &ev);
+		return;
+	}
+	if(xbtn == 1) {
+		mapped = MKFW_MOUSE_LEFT;
+	} else if(xbtn == 2) {
+		mapped = MKFW_MOUSE_MIDDLE;
+	} else if(xbtn == 3) {
+		mapped = MKFW_MOUSE_RIGHT;
+	} else if(xbtn == 8) {
+		mapped = MKFW_MOUSE_EXTRA1;
+	} else if(xbtn == 9) {
+		mapped = MKFW_MOUSE_EXTRA2;
+	} else {
+		return;
+	}
+	MKFW_EVENT_INIT(ev, 0, MKFW_EVENT_MOUSE_BUTTON, time);
+	ev.button.button = mapped;
+	ev.button.action = pressed ? MKFW_PRESSED : MKFW_RELEASED;
+	mkfw_event_ring_push(&ctx->raw_input, &ev);
+}
+
+// [=]===^=[ x11_input_thread_main ]==============================================================[=]
+// Sleeps in poll() until the input connection is readable, then drains
+// everything queued.  Motion within one drain collapses into one record,
+// flushed ahead of any button so ordering is preserved.
+static void *x11_input_thread_main(void *arg) {
+	struct mkfw_context *ctx = (struct mkfw_context *)arg;
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	Display *dpy = xc->input_display;
+	struct x11_server_clock clock = xc->server_clock;
+	struct mkfw_delta_accumulator motion = {0};
+
+	struct pollfd pfd[2];
+	pfd[0].fd = ConnectionNumber(dpy);
+	pfd[0].events = POLLIN;
+	pfd[1].fd = xc->input_wake[0];
+	pfd[1].events = POLLIN;
+
+	while(__atomic_load_n(&xc->input_thread_running, __ATOMIC_ACQUIRE)) {
+		int32_t pending = XEventsQueued(dpy, QueuedAfterReading);
+		if(pending == 0) {
+			pfd[0].revents = pfd[1].revents = 0;
+			poll(pfd, 2, -1);
+			continue;
+		}
+		while(pending > 0) {
+			for(; pending > 0; --pending) {
+				XEvent event;
+				XNextEvent(dpy, &event);
+				if(event.type != GenericEvent || event.xcookie.extension != xc->input_xi_opcode || !XGetEventData(dpy, &event.xcookie)) {
+					continue;
+				}
+				XIRawEvent *re = (XIRawEvent *)event.xcookie.data;
+				uint64_t t = x11_server_clock_to_ns(&clock, re->time);
+				if(event.xcookie.evtype == XI_RawMotion) {
+					double dx, dy;
+					x11_raw_motion_delta(re, &dx, &dy);
+					mkfw_delta_add(&motion, t, dx, dy);
+				} else {
+					uint32_t button = (uint32_t)re->detail;
+					if(button >= 1 && (int32_t)button <= xc->input_button_count) {
+						button = xc->input_button_map[button - 1];
+					}
+					x11_input_thread_flush_motion(ctx, &motion);
+					x11_input_thread_button(ctx, button, event.xcookie.evtype == XI_RawButtonPress, t);
+				}
+				XFreeEventData(dpy, &event.xcookie);
+			}
+			pending = XEventsQueued(dpy, QueuedAfterReading);
+		}
+		x11_input_thread_flush_motion(ctx, &motion);
+	}
+	return 0;
+}
+
+// [=]===^=[ x11_input_thread_start ]=============================================================[=]
+// Opens the thread's own connection and selects raw motion and buttons
+// from the master pointer on the root window, so input is seen whether
+// or not an mkfw window has focus.  Needs XI 2.1: an XI 2.0 client gets
+// no raw events while another client grabs the pointer, and the cursor
+// lock grabs it on the main connection.
+static uint32_t x11_input_thread_start(struct mkfw_context *ctx, struct mkfw_options *opts) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	Display *dpy = XOpenDisplay(0);
+	if(!dpy) {
+		mkfw_error("input thread: unable to open X display");
+		return 0;
+	}
+
+	int event, error;
+	int major = 2, minor = 2;
+	if(!XQueryExtension(dpy, "XInputExtension", &xc->input_xi_opcode, &event, &error) || XIQueryVersion(dpy, &major, &minor) == BadRequest) {
+		mkfw_error("input thread: XInput2 not available on this X server");
+		XCloseDisplay(dpy);
+		return 0;
+	}
+	if(major < 2 || (major == 2 && minor < 1)) {
+		mkfw_error("input thread: XInput 2.1 required, server has %d.%d", major, minor);
+		XCloseDisplay(dpy);
+		return 0;
+	}
+	xc->input_button_count = XGetPointerMapping(dpy, xc->input_button_map, sizeof(xc->input_button_map));
+
+	XIEventMask mask;
+	unsigned char mask_bytes[(XI_LASTEVENT + 7) / 8] = {0};
+	mask.deviceid = XIAllMasterDevices;
+	mask.mask_len = sizeof(mask_bytes);
+	mask.mask = mask_bytes;
+	XISetMask(mask.mask, XI_RawMotion);
+	XISetMask(mask.mask, XI_RawButtonPress);
+	XISetMask(mask.mask, XI_RawButtonRelease);
+	XISelectEvents(dpy, DefaultRootWindow(dpy), &mask, 1);
+	XFlush(dpy);
+
+	if(!mkfw_event_ring_create(&ctx->raw_input, opts->raw_input_capacity)) {
+		mkfw_error("input thread: out of memory");
+		XCloseDisplay(dpy);
+		return 0;
+	}
+	if(pipe(xc->input_wake) != 0) {
+		mkfw_error("input thread: unable to create wake pipe");
+		free(ctx->raw_input.events);
+		ctx->raw_input.events = 0;
+		XCloseDisplay(dpy);
+		return 0;
+	}
+
+	xc->input_display = dpy;
+	xc->input_thread_running = 1;
+	if(pthread_create(&xc->input_thread, 0, x11_input_thread_main, ctx) != 0) {
+		mkfw_error("input thread: unable to create thread");
+		xc->input_thread_running = 0;
+		xc->input_display = 0;
+		close(xc->input_wake[0]);
+		close(xc->input_wake[1]);
+		free(ctx->raw_input.events);
+		ctx->raw_input.events = 0;
+		XCloseDisplay(dpy);
+		return 0;
+	}
+	return 1;
+}
+
+// [=]===^=[ x11_input_thread_stop ]==============================================================[=]
+static void x11_input_thread_stop(struct mkfw_context *ctx) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	if(!xc->input_display) {
+		return;
+	}
+	__atomic_store_n(&xc->input_thread_running, 0, __ATOMIC_RELEASE);
+	uint8_t wake = 1;
+	ssize_t written = write(xc->input_wake[1], &wake, 1);
+	(void)written;
+	pthread_join(xc->input_thread, 0);
+	close(xc->input_wake[0]);
+	close(xc->input_wake[1]);
+	XCloseDisplay(xc->input_display);
+	xc->input_display = 0;
+	free(ctx->raw_input.events);
+	ctx->raw_input.events = 0;
+}
+
+// [=]===^=[ x11_loader_main ]====================================================================[=]
+// Load the extension libraries in the order mkfw_init needs them, then
+// libGL and libXcursor, which only the first window and custom cursors
+// use.  mkfw_init meanwhile opens the display and builds the keymap.
+static void *x11_loader_main(void *arg) {
+	struct x11_mkfw_context *xc = (struct x11_mkfw_context *)arg;
+	x11_need_xinput2();
+	x11_need_xrandr();
+	uint64_t start = mkfw_get_time();
+	x11_need_glx();
+	x11_need_xcursor();
+	xc->loader_ns = mkfw_get_time() - start;
+	__atomic_store_n(&xc->loader_done, 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+// [=]===^=[ x11_loader_reap ]====================================================================[=]
+// Join the loader once it is done, or with wait until it is, and publish
+// its timing on the owning thread.
+static void x11_loader_reap(struct mkfw_context *ctx, uint32_t wait) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	if(!xc->loader_running || (!wait && !__atomic_load_n(&xc->loader_done, __ATOMIC_ACQUIRE))) {
+		return;
+	}
+	pthread_join(xc->loader_thread, 0);
+	xc->loader_running = 0;
+	ctx->stats.startup.deferred_libs_ns = xc->loader_ns;
+}
+
 // [=]===^=[ mkfw_init ]==========================================================================[=]
 MKFW_API struct mkfw_context *mkfw_init(struct mkfw_options *opts) {
-	(void)opts;  // No fields yet beyond version
-
+	struct mkfw_options options;
+	mkfw_options_load(&options, opts);
+	opts = &options;
+	uint64_t init_start = mkfw_get_time();
 	struct mkfw_context *ctx = (struct mkfw_context *)calloc(1, sizeof(struct mkfw_context));
 	if(!ctx) {
 		mkfw_error("mkfw_init: out of memory");
 		return 0;
 	}
 	ctx->platform = calloc(1, sizeof(struct x11_mkfw_context));
-	if(!ctx->platform) {
+	if(!ctx->platform || !mkfw_context_apply_options(ctx, opts)) {
 		mkfw_error("mkfw_init: out of memory");
+		free(ctx->platform);
 		free(ctx);
 		return 0;
 	}
+	struct mkfw_startup_stats *startup = &ctx->stats.startup;
 
-	load_x11_functions();
-	load_xrandr_functions();
-	load_xinput2_functions();
-	load_xcursor_functions();   // optional: missing libXcursor disables custom cursors
+	uint64_t t = mkfw_get_time();
+	x11_need_x11();
 	CTX_PLATFORM(ctx)->libs_loaded = 1;
+	CTX_PLATFORM(ctx)->owner_thread = pthread_self();
+	if((ctx->flags & MKFW_INIT_NO_X_THREADS) && (ctx->flags & MKFW_INIT_INPUT_THREAD)) {
+		mkfw_error("mkfw_init: MKFW_INIT_NO_X_THREADS ignored with MKFW_INIT_INPUT_THREAD");
+		ctx->flags &= ~MKFW_INIT_NO_X_THREADS;
+	}
+	if(!(ctx->flags & MKFW_INIT_NO_X_THREADS)) {
+		XInitThreads();
+	}
+	CTX_PLATFORM(ctx)->loader_running = pthread_create(&CTX_PLATFORM(ctx)->loader_thread, 0, x11_loader_main, ctx->platform) == 0;
+	startup->libs_ns = mkfw_get_time() - t;
 
-	XInitThreads();
-
+	t = mkfw_get_time();
 	CTX_PLATFORM(ctx)->display = XOpenDisplay(0);
 	if(!CTX_PLATFORM(ctx)->display) {
 		mkfw_error("unable to open X display");
+		x11_loader_reap(ctx, 1);
+		free(ctx->event_queue.events);
 		free(ctx->platform);
 		free(ctx);
 		return 0;
 	}
+	startup->display_ns = mkfw_get_time() - t;
 
-	load_glx_functions(CTX_PLATFORM(ctx)->display);
-
+	t = mkfw_get_time();
 	XrmInitialize();
 
+	x11_round_trips(ctx, 1);
+	if(!XInternAtoms(CTX_PLATFORM(ctx)->display, x11_atom_names, X11_ATOM_COUNT, False, CTX_PLATFORM(ctx)->atoms)) {
+		mkfw_error("unable to intern atoms");
+	}
+	startup->atoms_ns = mkfw_get_time() - t;
+
+	t = mkfw_get_time();
+	x11_calibrate_server_time(ctx);
+	x11_build_keymap(ctx);
+
+	// Without detectable auto-repeat the server sends a Release/Press pair
+	// per repeat; KeyRelease then peeks the queue to fold the pair.
+	{
+		Bool supported = False;
+		x11_round_trips(ctx, 1);
+		XkbSetDetectableAutoRepeat(CTX_PLATFORM(ctx)->display, True, &supported);
+		CTX_PLATFORM(ctx)->detectable_repeat = supported ? 1 : 0;
+	}
+
+	uint64_t wait = mkfw_get_time();
+	x11_need_xinput2();
+	wait = mkfw_get_time() - wait;
+	x11_query_xi2(ctx);
+	startup->libs_ns += wait;
+	startup->input_ns = mkfw_get_time() - t - wait;
+
+	// A failed input thread is reported but not fatal; mkfw_next_raw_event
+	// then simply returns 0.
+	if(opts->flags & MKFW_INIT_INPUT_THREAD) {
+		x11_input_thread_start(ctx, opts);
+	}
+
+	if(opts->gl_version_cache) {
+		CTX_PLATFORM(ctx)->gl_version_cache = strdup(opts->gl_version_cache);
+	}
+
 	// Subscribe to monitor hotplug; RRScreenChangeNotify is handled in the
 	// event loop, which refreshes the cache and fires the monitor callback.
+	t = mkfw_get_time();
+	x11_need_xrandr();
+	wait = mkfw_get_time() - t;
 	CTX_PLATFORM(ctx)->xrandr_event_base = -1;
 	{
 		int event_base = 0, error_base = 0;
@@ -745,25 +1928,38 @@ MKFW_API struct mkfw_context *mkfw_init(struct mkfw_options *opts) {
 
 	// Cache monitors so callers can query before creating a window
 	ctx->monitor_count = (uint32_t)mkfw_query_monitors_into(ctx);
+	startup->libs_ns += wait;
+	startup->monitors_ns = mkfw_get_time() - t - wait;
 
+	startup->init_ns = mkfw_get_time() - init_start;
 	return ctx;
 }
 
-// [=]===^=[ mkfw_window_create ]=================================================================[=]
-MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct mkfw_window_options *opts) {
-	if(!ctx) {
-		mkfw_error("mkfw_window_create: ctx is null");
-		return 0;
+// [=]===^=[ x11_window_initial_wm_state ]========================================================[=]
+// Initial _NET_WM_STATE hints (always-on-top, maximized) must be set on the
+// unmapped window so the WM honours them at map time.  Replaces whatever a
+// recycled window was left with.
+static void x11_window_initial_wm_state(struct mkfw_window *state, uint32_t flags) {
+	Atom states[3];
+	int32_t ns = 0;
+	if(flags & MKFW_WIN_FLOATING) {
+		states[ns++] = X11_ATOM(state, NET_WM_STATE_ABOVE);
 	}
-	if(ctx->window_count >= MKFW_MAX_WINDOWS) {
-		mkfw_error("mkfw_window_create: context already at MKFW_MAX_WINDOWS (%d)", MKFW_MAX_WINDOWS);
-		return 0;
+	if(flags & MKFW_WIN_MAXIMIZED) {
+		states[ns++] = X11_ATOM(state, NET_WM_STATE_MAXIMIZED_HORZ);
+		states[ns++] = X11_ATOM(state, NET_WM_STATE_MAXIMIZED_VERT);
 	}
-
-	struct mkfw_window_options defaults = {0};
-	if(!opts) {
-		opts = &defaults;
+	if(ns > 0) {
+		XChangeProperty(PLATFORM(state)->display, PLATFORM(state)->window, X11_ATOM(state, NET_WM_STATE), XA_ATOM, 32, PropModeReplace, (unsigned char *)states, ns);
+	} else {
+		XDeleteProperty(PLATFORM(state)->display, PLATFORM(state)->window, X11_ATOM(state, NET_WM_STATE));
 	}
+}
+
+// [=]===^=[ x11_window_create ]==================================================================[=]
+// Create the native window and its GL context, registered for event
+// routing but not in ctx->windows[] and not mapped.
+static struct mkfw_window *x11_window_create(struct mkfw_context *ctx, struct mkfw_window_options *opts) {
 	uint32_t graphics_api = opts->graphics_api;
 	if(graphics_api == MKFW_GFX_GLES || graphics_api == MKFW_GFX_VULKAN) {
 		mkfw_error("graphics_api %u not supported (only MKFW_GFX_GL and MKFW_GFX_NONE)", graphics_api);
@@ -775,7 +1971,7 @@ MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct
 	int32_t gl_major = opts->gl_major;
 	int32_t gl_minor = opts->gl_minor;
 	if(gl_major == 0 && graphics_api == MKFW_GFX_GL) {
-		if(!mkfw_query_max_gl_version(&gl_major, &gl_minor)) {
+		if(!x11_context_gl_version(ctx, &gl_major, &gl_minor)) {
 			mkfw_error("mkfw_window_create: unable to query driver's maximum OpenGL version");
 			return 0;
 		}
@@ -786,6 +1982,9 @@ MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct
 		? GLX_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB
 		: GLX_CONTEXT_CORE_PROFILE_BIT_ARB;
 	const char *gl_profile_name = (opts->gl_profile == MKFW_GL_PROFILE_COMPAT) ? "Compatibility" : "Core";
+	if(!x11_window_map_reserve(ctx)) {
+		return 0;
+	}
 
 	struct mkfw_window *state = (struct mkfw_window *)calloc(1, sizeof(struct mkfw_window));
 	if(!state) {
@@ -802,7 +2001,7 @@ MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct
 	}
 
 	PLATFORM(state)->mouse_sensitivity = 1.0;
-	PLATFORM(state)->xi_opcode = -1;
+	PLATFORM(state)->xi_opcode = CTX_PLATFORM(ctx)->xi_opcode;
 	PLATFORM(state)->display = CTX_PLATFORM(ctx)->display;
 	PLATFORM(state)->graphics_api = graphics_api;
 	PLATFORM(state)->cursor_visible = 1;
@@ -816,7 +2015,9 @@ MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct
 	GLXFBConfig fb_config = 0;
 
 	if(graphics_api == MKFW_GFX_GL) {
-		fb_config = select_best_fbconfig_for(display, screen, transparent, opts->depth_bits, opts->stencil_bits, opts->samples, opts->srgb);
+		uint32_t fbconfig_count = 0;
+		struct x11_fbconfig *fbconfigs = x11_context_fbconfigs(ctx, &fbconfig_count);
+		fb_config = select_best_fbconfig_for(display, fbconfigs, fbconfig_count, transparent, opts->depth_bits, opts->stencil_bits, opts->samples, opts->srgb);
 		if(!fb_config) {
 			free(state->platform);
 			free(state);
@@ -840,11 +2041,14 @@ MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct
 	Colormap cmap = XCreateColormap(display, root, vi->visual, AllocNone);
 	XSetWindowAttributes swa;
 	swa.colormap = cmap;
-	swa.event_mask = ExposureMask | KeyPressMask | KeyReleaseMask | ButtonPressMask | ButtonReleaseMask | PointerMotionMask | StructureNotifyMask | EnterWindowMask | LeaveWindowMask | FocusChangeMask | PropertyChangeMask;
+	PLATFORM(state)->event_mask = x11_window_event_mask(state);
+	swa.event_mask = PLATFORM(state)->event_mask;
 	swa.border_pixel = 0;
 	swa.background_pixmap = None;
 
 	PLATFORM(state)->window = XCreateWindow(display, root, 0, 0, width, height, 0, vi->depth, InputOutput, vi->visual, CWBackPixmap | CWBorderPixel | CWColormap | CWEventMask, &swa);
+	PLATFORM(state)->cached_width  = width;
+	PLATFORM(state)->cached_height = height;
 
 	XStoreName(display, PLATFORM(state)->window, title);
 
@@ -856,9 +2060,7 @@ MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct
 		XFree(class_hint);
 	}
 
-	PLATFORM(state)->wm_delete_window = XInternAtom(display, "WM_DELETE_WINDOW", False);
-	XSetWMProtocols(display, PLATFORM(state)->window, &PLATFORM(state)->wm_delete_window, 1);
-	enable_xi2_raw_input(state);
+	XSetWMProtocols(display, PLATFORM(state)->window, &X11_ATOM(state, WM_DELETE_WINDOW), 1);
 
 	if(graphics_api == MKFW_GFX_GL) {
 		if(!glXCreateContextAttribsARB) {
@@ -888,9 +2090,20 @@ MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct
 
 		GLXContext share_ctx = opts->share_window ? PLATFORM(opts->share_window)->glctx : 0;
 		PLATFORM(state)->glctx = glXCreateContextAttribsARB(display, fb_config, share_ctx, 1, ctx_attribs);
+		struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+		if(!PLATFORM(state)->glctx && opts->gl_major == 0 && xc->gl_from_cache) {
+			// The cached version is stale: drop the entry, probe, retry.
+			remove(xc->gl_version_cache);
+			xc->gl_probed = 0;
+			if(x11_context_gl_version(ctx, &gl_major, &gl_minor)) {
+				ctx_attribs[1] = gl_major;
+				ctx_attribs[3] = gl_minor;
+				PLATFORM(state)->glctx = glXCreateContextAttribsARB(display, fb_config, share_ctx, 1, ctx_attribs);
+			}
+		}
 		if(!PLATFORM(state)->glctx) {
 			int32_t max_major = 0, max_minor = 0;
-			mkfw_query_max_gl_version(&max_major, &max_minor);
+			x11_context_gl_version(ctx, &max_major, &max_minor);
 			if(max_major > 0) {
 				mkfw_error("OpenGL %d.%d %s Profile not available (driver supports up to %d.%d)",
 					gl_major, gl_minor, gl_profile_name, max_major, max_minor);
@@ -904,83 +2117,285 @@ MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct
 			return 0;
 		}
 
-		glXMakeCurrent(display, PLATFORM(state)->window, PLATFORM(state)->glctx);
-		XFree(vi);
+		glXMakeCurrent(display, PLATFORM(state)->window, PLATFORM(state)->glctx);
+		XFree(vi);
+
+		x11_present_resolve(ctx);
+		PLATFORM(state)->has_sync = x11_gl_context_has_sync();
+		if(CTX_PLATFORM(ctx)->present_source == MKFW_PRESENT_INTEL) {
+			PFNGLXSELECTEVENTPROC pglXSelectEvent = (PFNGLXSELECTEVENTPROC)glXGetProcAddress((const unsigned char *)"glXSelectEvent");
+			if(pglXSelectEvent) {
+				pglXSelectEvent(display, PLATFORM(state)->window, GLX_BUFFER_SWAP_COMPLETE_INTEL_MASK);
+			}
+		}
+	}
+
+	x11_window_update_xic(state);
+
+	state->has_focus = 1;
+	PLATFORM(state)->last_content_scale = mkfw_compute_content_scale(display);
+
+	x11_window_initial_wm_state(state, opts->flags);
+
+	// _NET_WM_USER_TIME of 0 tells the WM not to focus the window on map.
+	if(opts->flags & MKFW_WIN_NO_FOCUS) {
+		long zero = 0;
+		XChangeProperty(display, PLATFORM(state)->window, X11_ATOM(state, NET_WM_USER_TIME), XA_CARDINAL, 32, PropModeReplace, (unsigned char *)&zero, 1);
+		state->has_focus = 0;
+	}
+
+	PLATFORM(state)->options = *opts;
+	PLATFORM(state)->options.title = 0;
+	PLATFORM(state)->options.x11_class_name = 0;
+	x11_window_map_insert(ctx, PLATFORM(state)->window, state);
+
+	return state;
+}
+
+MKFW_API void mkfw_window_set_title(struct mkfw_window *state, const char *title);
+
+// [=]===^=[ x11_window_pool_take ]===============================================================[=]
+static struct mkfw_window *x11_window_pool_take(struct mkfw_context *ctx, struct mkfw_window_options *opts) {
+	for(uint32_t i = 0; i < ctx->pool_count; ++i) {
+		struct mkfw_window *state = ctx->pool[i];
+		if(mkfw_window_options_compatible(&PLATFORM(state)->options, opts)) {
+			ctx->pool[i] = ctx->pool[--ctx->pool_count];
+			ctx->pool[ctx->pool_count] = 0;
+			return state;
+		}
+	}
+	return 0;
+}
+
+// [=]===^=[ x11_frame_fences_clear ]=============================================================[=]
+// Drop every outstanding frame fence; the window's context must be current.
+static void x11_frame_fences_clear(struct mkfw_window *state) {
+	struct x11_mkfw_window *xw = PLATFORM(state);
+	struct x11_mkfw_context *xc = CTX_PLATFORM(state->context);
+	for(uint32_t i = 0; i < MKFW_MAX_FRAMES_IN_FLIGHT; ++i) {
+		if(xw->fences[i]) {
+			xc->glDeleteSync(xw->fences[i]);
+			xw->fences[i] = 0;
+		}
+	}
+	xw->fence_head = 0;
+}
+
+// [=]===^=[ x11_window_handout ]=================================================================[=]
+// Give a pooled window the size, title and class of a new request.  The
+// GL context, visual and creation-time WM hints already match.
+static void x11_window_handout(struct mkfw_window *state, struct mkfw_window_options *opts) {
+	Display *display = PLATFORM(state)->display;
+	int32_t width  = opts->width  > 0 ? opts->width  : 1280;
+	int32_t height = opts->height > 0 ? opts->height : 720;
+	if(width != PLATFORM(state)->cached_width || height != PLATFORM(state)->cached_height) {
+		XResizeWindow(display, PLATFORM(state)->window, width, height);
+		PLATFORM(state)->cached_width  = width;
+		PLATFORM(state)->cached_height = height;
+	}
+	mkfw_window_set_title(state, opts->title ? opts->title : "mkfw");
+
+	XClassHint *class_hint = XAllocClassHint();
+	if(class_hint) {
+		class_hint->res_name  = (char *)(opts->x11_class_name ? opts->x11_class_name : "mkfw");
+		class_hint->res_class = (char *)(opts->x11_class_name ? opts->x11_class_name : "MKFW");
+		XSetClassHint(display, PLATFORM(state)->window, class_hint);
+		XFree(class_hint);
+	}
+
+	PLATFORM(state)->options = *opts;
+	PLATFORM(state)->options.title = 0;
+	PLATFORM(state)->options.x11_class_name = 0;
+	state->has_focus = (opts->flags & MKFW_WIN_NO_FOCUS) ? 0 : 1;
+
+	if(PLATFORM(state)->glctx) {
+		glXMakeCurrent(display, PLATFORM(state)->window, PLATFORM(state)->glctx);
+		x11_frame_fences_clear(state);
+	}
+}
+
+// [=]===^=[ mkfw_window_create ]=================================================================[=]
+MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct mkfw_window_options *opts) {
+	if(!ctx) {
+		mkfw_error("mkfw_window_create: ctx is null");
+		return 0;
+	}
+	X11_CHECK_THREAD(ctx);
+	if(!mkfw_context_reserve_window(ctx)) {
+		return 0;
+	}
+
+	struct mkfw_window_options options;
+	mkfw_window_options_load(&options, opts);
+	opts = &options;
+
+	uint64_t start = mkfw_get_time();
+	struct mkfw_window *state = x11_window_pool_take(ctx, opts);
+	if(state) {
+		x11_window_handout(state, opts);
+	} else {
+		state = x11_window_create(ctx, opts);
+		if(!state) {
+			return 0;
+		}
+	}
+	if(!ctx->stats.startup.first_window_ns) {
+		ctx->stats.startup.first_window_ns = mkfw_get_time() - start;
+	}
+	x11_loader_reap(ctx, 0);
+
+	mkfw_context_link_window(ctx, state);
+
+	// Polling would otherwise only select raw motion on the first
+	// mkfw_window_get_and_clear_mouse_delta, which then reads nothing.
+	if(opts->flags & MKFW_WIN_POLL_DELTA) {
+		PLATFORM(state)->delta_polled = 1;
+		x11_update_raw_motion(ctx);
+	}
+
+	if(!(opts->flags & MKFW_WIN_HIDDEN)) {
+		XMapWindow(PLATFORM(state)->display, PLATFORM(state)->window);
+		x11_flush(state->context);
 	}
 
-	PLATFORM(state)->xim = XOpenIM(display, 0, 0, 0);
-	if(PLATFORM(state)->xim) {
-		PLATFORM(state)->xic = XCreateIC(PLATFORM(state)->xim, XNInputStyle, XIMPreeditNothing | XIMStatusNothing, XNClientWindow, PLATFORM(state)->window, XNFocusWindow, PLATFORM(state)->window, (char *)0);
-	}
-
-	PLATFORM(state)->cursors[MKFW_CURSOR_ARROW]       = XCreateFontCursor(display, XC_left_ptr);
-	PLATFORM(state)->cursors[MKFW_CURSOR_TEXT_INPUT]  = XCreateFontCursor(display, XC_xterm);
-	PLATFORM(state)->cursors[MKFW_CURSOR_RESIZE_ALL]  = XCreateFontCursor(display, XC_fleur);
-	PLATFORM(state)->cursors[MKFW_CURSOR_RESIZE_NS]   = XCreateFontCursor(display, XC_sb_v_double_arrow);
-	PLATFORM(state)->cursors[MKFW_CURSOR_RESIZE_EW]   = XCreateFontCursor(display, XC_sb_h_double_arrow);
-	PLATFORM(state)->cursors[MKFW_CURSOR_RESIZE_NESW] = XCreateFontCursor(display, XC_bottom_left_corner);
-	PLATFORM(state)->cursors[MKFW_CURSOR_RESIZE_NWSE] = XCreateFontCursor(display, XC_bottom_right_corner);
-	PLATFORM(state)->cursors[MKFW_CURSOR_HAND]        = XCreateFontCursor(display, XC_hand2);
-	PLATFORM(state)->cursors[MKFW_CURSOR_NOT_ALLOWED] = XCreateFontCursor(display, XC_X_cursor);
-
-	PLATFORM(state)->clipboard_atom      = XInternAtom(display, "CLIPBOARD", False);
-	PLATFORM(state)->utf8_string_atom    = XInternAtom(display, "UTF8_STRING", False);
-	PLATFORM(state)->targets_atom        = XInternAtom(display, "TARGETS", False);
-	PLATFORM(state)->mkfw_clipboard_atom = XInternAtom(display, "MKFW_CLIPBOARD", False);
-
-	PLATFORM(state)->xdnd_aware     = XInternAtom(display, "XdndAware", False);
-	PLATFORM(state)->xdnd_enter     = XInternAtom(display, "XdndEnter", False);
-	PLATFORM(state)->xdnd_position  = XInternAtom(display, "XdndPosition", False);
-	PLATFORM(state)->xdnd_status    = XInternAtom(display, "XdndStatus", False);
-	PLATFORM(state)->xdnd_leave     = XInternAtom(display, "XdndLeave", False);
-	PLATFORM(state)->xdnd_drop      = XInternAtom(display, "XdndDrop", False);
-	PLATFORM(state)->xdnd_finished  = XInternAtom(display, "XdndFinished", False);
-	PLATFORM(state)->xdnd_selection = XInternAtom(display, "XdndSelection", False);
-	PLATFORM(state)->xdnd_type_list = XInternAtom(display, "XdndTypeList", False);
-	PLATFORM(state)->text_uri_list  = XInternAtom(display, "text/uri-list", False);
-
-	PLATFORM(state)->net_wm_state                = XInternAtom(display, "_NET_WM_STATE", False);
-	PLATFORM(state)->net_wm_state_maximized_horz = XInternAtom(display, "_NET_WM_STATE_MAXIMIZED_HORZ", False);
-	PLATFORM(state)->net_wm_state_maximized_vert = XInternAtom(display, "_NET_WM_STATE_MAXIMIZED_VERT", False);
-	PLATFORM(state)->wm_state                    = XInternAtom(display, "WM_STATE", False);
-	PLATFORM(state)->net_wm_state_demands_attention = XInternAtom(display, "_NET_WM_STATE_DEMANDS_ATTENTION", False);
+	return state;
+}
 
-	state->has_focus = 1;
-	PLATFORM(state)->last_content_scale = mkfw_compute_content_scale(display);
+// [=]===^=[ x11_gl_probe_main ]==================================================================[=]
+// Driver load and the throwaway probe context are the slow part of a first
+// GL window.  On a worker they overlap the caller's frames, and leave the
+// driver loaded for the real context.  The worker shares the context's
+// connection (Xlib is thread-safe here, MKFW_INIT_NO_X_THREADS never
+// starts it) and only touches the probe_* fields.
+static void *x11_gl_probe_main(void *arg) {
+	struct x11_mkfw_context *xc = (struct x11_mkfw_context *)arg;
+	int32_t major = 0, minor = 0;
+	if(x11_probe_gl_context(xc->display, xc->probe_fbconfig, &major, &minor, &xc->probe_error)) {
+		xc->probe_major = major;
+		xc->probe_minor = minor;
+	}
+	__atomic_store_n(&xc->probe_done, 1, __ATOMIC_RELEASE);
+	return 0;
+}
 
-	// Initial _NET_WM_STATE hints (always-on-top, maximized) must be set on the
-	// unmapped window so the WM honours them at map time.
-	{
-		Atom states[3];
-		int32_t ns = 0;
-		if(opts->flags & MKFW_WIN_FLOATING) {
-			states[ns++] = XInternAtom(display, "_NET_WM_STATE_ABOVE", False);
+// [=]===^=[ x11_window_request_step ]============================================================[=]
+// Called by the pump: create the oldest requested window once the GL
+// version it needs is known.  One per pump, so a burst of requests is
+// spread over frames.
+static void x11_window_request_step(struct mkfw_context *ctx) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	if(!ctx->window_requests) {
+		return;
+	}
+	if(xc->probe_running) {
+		if(!__atomic_load_n(&xc->probe_done, __ATOMIC_ACQUIRE)) {
+			return;
 		}
-		if(opts->flags & MKFW_WIN_MAXIMIZED) {
-			states[ns++] = PLATFORM(state)->net_wm_state_maximized_horz;
-			states[ns++] = PLATFORM(state)->net_wm_state_maximized_vert;
+		pthread_join(xc->probe_thread, 0);
+		xc->probe_running = 0;
+		if(xc->probe_error) {
+			mkfw_error("mkfw_window_create_async: %s", xc->probe_error);
 		}
-		if(ns > 0) {
-			XChangeProperty(display, PLATFORM(state)->window, PLATFORM(state)->net_wm_state, XA_ATOM, 32, PropModeReplace, (unsigned char *)states, ns);
+		if(!xc->gl_probed) {
+			xc->gl_probed = 1;
+			xc->gl_max_major = xc->probe_major;
+			xc->gl_max_minor = xc->probe_minor;
 		}
 	}
 
-	// _NET_WM_USER_TIME of 0 tells the WM not to focus the window on map.
-	if(opts->flags & MKFW_WIN_NO_FOCUS) {
-		Atom net_wm_user_time = XInternAtom(display, "_NET_WM_USER_TIME", False);
-		long zero = 0;
-		XChangeProperty(display, PLATFORM(state)->window, net_wm_user_time, XA_CARDINAL, 32, PropModeReplace, (unsigned char *)&zero, 1);
-		state->has_focus = 0;
+	struct mkfw_window_request *req = mkfw_window_request_pop(ctx);
+	req->window = mkfw_window_create(ctx, &req->options);
+	req->ready = 1;
+	if(req->callback) {
+		req->callback(req);
 	}
+}
 
-	ctx->windows[ctx->window_count++] = state;
+// [=]===^=[ mkfw_window_create_async ]===========================================================[=]
+// Queue a window for creation by mkfw_poll_events and return at once.  A
+// GL request that needs the driver's maximum version starts the probe on
+// a worker thread, unless the version is cached or already known, or the
+// context is MKFW_INIT_NO_X_THREADS.
+MKFW_API uint32_t mkfw_window_create_async(struct mkfw_context *ctx, struct mkfw_window_options *opts, struct mkfw_window_request *req) {
+	if(!ctx || !req) {
+		mkfw_error("mkfw_window_create_async: ctx or req is null");
+		return 0;
+	}
+	mkfw_window_request_queue(ctx, opts, req);
+
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	struct mkfw_window_options *o = &req->options;
+	if(o->graphics_api == MKFW_GFX_GL && o->gl_major == 0 && !xc->gl_probed && !xc->probe_running && !xc->gl_version_cache && !(ctx->flags & MKFW_INIT_NO_X_THREADS)) {
+		// The fbconfig table and choice stay on this thread; the worker
+		// only creates the probe context.
+		uint32_t fbconfig_count = 0;
+		struct x11_fbconfig *fbconfigs = x11_context_fbconfigs(ctx, &fbconfig_count);
+		xc->probe_fbconfig = select_best_fbconfig_for(xc->display, fbconfigs, fbconfig_count, 0, 0, 0, 0, 0);
+		if(xc->probe_fbconfig) {
+			xc->probe_done = 0;
+			xc->probe_error = 0;
+			xc->probe_running = pthread_create(&xc->probe_thread, 0, x11_gl_probe_main, xc) == 0;
+		}
+	}
+	return 1;
+}
 
-	if(!(opts->flags & MKFW_WIN_HIDDEN)) {
-		XMapWindow(display, PLATFORM(state)->window);
-		XFlush(display);
+// [=]===^=[ mkfw_window_pool_fill ]==============================================================[=]
+// Create hidden windows for opts ahead of time, up to count in the pool
+// and MKFW_MAX_POOLED_WINDOWS in total.  Returns how many were added.
+MKFW_API uint32_t mkfw_window_pool_fill(struct mkfw_context *ctx, struct mkfw_window_options *opts, uint32_t count) {
+	if(!ctx) {
+		return 0;
+	}
+	struct mkfw_window_options pooled;
+	mkfw_window_options_load(&pooled, opts);
+	pooled.flags |= MKFW_WIN_HIDDEN;
+
+	uint32_t added = 0;
+	while(added < count && ctx->pool_count < MKFW_MAX_POOLED_WINDOWS) {
+		struct mkfw_window *state = x11_window_create(ctx, &pooled);
+		if(!state) {
+			break;
+		}
+		ctx->pool[ctx->pool_count++] = state;
+		++added;
+	}
+	x11_flush(ctx);
+	return added;
+}
+
+// X font cursor for each MKFW_CURSOR_* shape.
+static const uint32_t x11_cursor_shapes[MKFW_CURSOR_LAST] = {
+	[MKFW_CURSOR_ARROW]       = XC_left_ptr,
+	[MKFW_CURSOR_TEXT_INPUT]  = XC_xterm,
+	[MKFW_CURSOR_RESIZE_ALL]  = XC_fleur,
+	[MKFW_CURSOR_RESIZE_NS]   = XC_sb_v_double_arrow,
+	[MKFW_CURSOR_RESIZE_EW]   = XC_sb_h_double_arrow,
+	[MKFW_CURSOR_RESIZE_NESW] = XC_bottom_left_corner,
+	[MKFW_CURSOR_RESIZE_NWSE] = XC_bottom_right_corner,
+	[MKFW_CURSOR_HAND]        = XC_hand2,
+	[MKFW_CURSOR_NOT_ALLOWED] = XC_X_cursor,
+};
+
+// [=]===^=[ x11_shape_cursor ]===================================================================[=]
+static Cursor x11_shape_cursor(struct mkfw_context *ctx, uint32_t shape) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	if(!xc->cursors[shape]) {
+		xc->cursors[shape] = XCreateFontCursor(xc->display, x11_cursor_shapes[shape]);
 	}
+	return xc->cursors[shape];
+}
 
-	return state;
+// [=]===^=[ x11_hidden_cursor ]==================================================================[=]
+static Cursor x11_hidden_cursor(struct mkfw_context *ctx) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	if(!xc->hidden_cursor) {
+		Pixmap pixmap = XCreatePixmap(xc->display, DefaultRootWindow(xc->display), 1, 1, 1);
+		XColor black = {0};
+		xc->hidden_cursor = XCreatePixmapCursor(xc->display, pixmap, pixmap, &black, &black, 0, 0);
+		XFreePixmap(xc->display, pixmap);
+	}
+	return xc->hidden_cursor;
 }
 
 // [=]===^=[ x11_active_cursor ]==================================================================[=]
@@ -988,29 +2403,26 @@ static Cursor x11_active_cursor(struct mkfw_window *state) {
 	if(PLATFORM(state)->active_custom_cursor) {
 		return PLATFORM(state)->active_custom_cursor;
 	}
-	return PLATFORM(state)->cursors[PLATFORM(state)->current_cursor];
+	return x11_shape_cursor(state->context, PLATFORM(state)->current_cursor);
 }
 
 // [=]===^=[ mkfw_window_set_cursor_visible ]=====================================================[=]
 MKFW_API void mkfw_window_set_cursor_visible(struct mkfw_window *state, uint32_t visible) {
+	X11_CHECK_THREAD(state->context);
 	PLATFORM(state)->cursor_visible = visible ? 1 : 0;
 	if(visible) {
 		XDefineCursor(PLATFORM(state)->display, PLATFORM(state)->window, x11_active_cursor(state));
 	} else {
-		if(!PLATFORM(state)->hidden_cursor) {
-			Pixmap pixmap = XCreatePixmap(PLATFORM(state)->display, PLATFORM(state)->window, 1, 1, 1);
-			XColor black = {0};
-			PLATFORM(state)->hidden_cursor = XCreatePixmapCursor(PLATFORM(state)->display, pixmap, pixmap, &black, &black, 0, 0);
-			XFreePixmap(PLATFORM(state)->display, pixmap);
-		}
-		XDefineCursor(PLATFORM(state)->display, PLATFORM(state)->window, PLATFORM(state)->hidden_cursor);
+		XDefineCursor(PLATFORM(state)->display, PLATFORM(state)->window, x11_hidden_cursor(state->context));
 	}
-	XFlush(PLATFORM(state)->display);
+	x11_flush(state->context);
 }
 
 // [=]===^=[ mkfw_window_set_cursor_locked ]======================================================[=]
 MKFW_API void mkfw_window_set_cursor_locked(struct mkfw_window *state, uint32_t locked) {
+	X11_CHECK_THREAD(state->context);
 	if(locked) {
+		x11_round_trips(state->context, 1);
 		int result = XGrabPointer(PLATFORM(state)->display, PLATFORM(state)->window, True, ButtonPressMask | ButtonReleaseMask | PointerMotionMask | FocusChangeMask, GrabModeAsync, GrabModeAsync, PLATFORM(state)->window, None, CurrentTime);
 		if(result != GrabSuccess) {
 			mkfw_error("failed to grab pointer");
@@ -1021,7 +2433,8 @@ MKFW_API void mkfw_window_set_cursor_locked(struct mkfw_window *state, uint32_t
 		XUngrabPointer(PLATFORM(state)->display, CurrentTime);
 		PLATFORM(state)->cursor_locked = 0;
 	}
-	XFlush(PLATFORM(state)->display);
+	mkfw_window_update_event_mask(state);
+	x11_flush(state->context);
 }
 
 // [=]===^=[ mkfw_window_is_cursor_visible ]======================================================[=]
@@ -1050,6 +2463,28 @@ static int32_t mkfw_xrandr_mode_refresh(XRRModeInfo *mi) {
 	return (int32_t)((double)mi->dotClock / ((double)mi->hTotal * (double)mi->vTotal) + 0.5);
 }
 
+// [=]===^=[ x11_window_position ]================================================================[=]
+// Root-relative window origin, served from ConfigureNotify.  Only right
+// after a reparent, before the WM has reported the frame position, does
+// this translate once.
+static void x11_window_position(struct mkfw_window *state, int32_t *x, int32_t *y) {
+	if(!PLATFORM(state)->have_cached_pos) {
+		Window child;
+		int32_t tx, ty;
+		x11_round_trips(state->context, 1);
+		XTranslateCoordinates(PLATFORM(state)->display, PLATFORM(state)->window, DefaultRootWindow(PLATFORM(state)->display), 0, 0, &tx, &ty, &child);
+		PLATFORM(state)->cached_x = tx;
+		PLATFORM(state)->cached_y = ty;
+		PLATFORM(state)->have_cached_pos = 1;
+	}
+	if(x) {
+		*x = PLATFORM(state)->cached_x;
+	}
+	if(y) {
+		*y = PLATFORM(state)->cached_y;
+	}
+}
+
 // [=]===^=[ mkfw_send_net_wm_fullscreen ]====================================================================[=]
 // Toggle _NET_WM_STATE_FULLSCREEN on the window via the WM.  add != 0 enters
 // fullscreen, add == 0 leaves it.
@@ -1058,10 +2493,10 @@ static void mkfw_send_net_wm_fullscreen(struct mkfw_window *state, int32_t add)
 	XEvent xev = {0};
 	xev.type = ClientMessage;
 	xev.xclient.window = PLATFORM(state)->window;
-	xev.xclient.message_type = XInternAtom(dpy, "_NET_WM_STATE", False);
+	xev.xclient.message_type = X11_ATOM(state, NET_WM_STATE);
 	xev.xclient.format = 32;
 	xev.xclient.data.l[0] = add ? 1 : 0;  // _NET_WM_STATE_ADD / _REMOVE
-	xev.xclient.data.l[1] = XInternAtom(dpy, "_NET_WM_STATE_FULLSCREEN", False);
+	xev.xclient.data.l[1] = X11_ATOM(state, NET_WM_STATE_FULLSCREEN);
 	xev.xclient.data.l[2] = 0;
 	XSendEvent(dpy, DefaultRootWindow(dpy), False, SubstructureRedirectMask | SubstructureNotifyMask, &xev);
 }
@@ -1073,13 +2508,10 @@ MKFW_API void mkfw_window_set_fullscreen(struct mkfw_window *state, int32_t enab
 
 	if(enable && !state->is_fullscreen) {
 		// Save current geometry for restore
-		XWindowAttributes attrs;
-		Window dummy_child;
-		int root_x = 0, root_y = 0;
-		XGetWindowAttributes(dpy, PLATFORM(state)->window, &attrs);
-		PLATFORM(state)->win_saved_width = attrs.width;
-		PLATFORM(state)->win_saved_height = attrs.height;
-		XTranslateCoordinates(dpy, PLATFORM(state)->window, DefaultRootWindow(dpy), 0, 0, &root_x, &root_y, &dummy_child);
+		int32_t root_x = 0, root_y = 0;
+		x11_window_position(state, &root_x, &root_y);
+		PLATFORM(state)->win_saved_width = PLATFORM(state)->cached_width;
+		PLATFORM(state)->win_saved_height = PLATFORM(state)->cached_height;
 		PLATFORM(state)->win_saved_x = root_x;
 		PLATFORM(state)->win_saved_y = root_y;
 
@@ -1106,10 +2538,12 @@ MKFW_API void mkfw_window_set_fullscreen(struct mkfw_window *state, int32_t enab
 		// Optional exclusive mode change on the target monitor's crtc.
 		if(mode && ctx->monitor_count > 0) {
 			Window root = DefaultRootWindow(dpy);
+			x11_round_trips(ctx, 1);
 			XRRScreenResources *sr = XRRGetScreenResourcesCurrent(dpy, root);
 			if(sr) {
 				RROutput output = CTX_PLATFORM(ctx)->monitor_output[idx];
 				RRCrtc crtc = CTX_PLATFORM(ctx)->monitor_crtc[idx];
+				x11_round_trips(ctx, 1);
 				XRROutputInfo *oi = XRRGetOutputInfo(dpy, sr, output);
 				RRMode chosen = None;
 				if(oi) {
@@ -1136,6 +2570,7 @@ MKFW_API void mkfw_window_set_fullscreen(struct mkfw_window *state, int32_t enab
 					XRRFreeOutputInfo(oi);
 				}
 				if(chosen != None) {
+					x11_round_trips(ctx, 1);
 					XRRCrtcInfo *ci = XRRGetCrtcInfo(dpy, sr, crtc);
 					if(ci) {
 						PLATFORM(state)->saved_crtc = crtc;
@@ -1164,8 +2599,10 @@ MKFW_API void mkfw_window_set_fullscreen(struct mkfw_window *state, int32_t enab
 		// Restore the monitor's original mode if we changed it.
 		if(PLATFORM(state)->saved_crtc != None) {
 			Window root = DefaultRootWindow(dpy);
+			x11_round_trips(ctx, 1);
 			XRRScreenResources *sr = XRRGetScreenResourcesCurrent(dpy, root);
 			if(sr) {
+				x11_round_trips(ctx, 1);
 				XRRCrtcInfo *ci = XRRGetCrtcInfo(dpy, sr, PLATFORM(state)->saved_crtc);
 				if(ci) {
 					XRRSetCrtcConfig(dpy, sr, PLATFORM(state)->saved_crtc, CurrentTime, ci->x, ci->y, PLATFORM(state)->saved_mode, ci->rotation, ci->outputs, ci->noutput);
@@ -1181,18 +2618,18 @@ MKFW_API void mkfw_window_set_fullscreen(struct mkfw_window *state, int32_t enab
 		state->is_fullscreen = 0;
 	}
 
-	XFlush(dpy);
+	x11_flush(state->context);
 }
 
 // [=]===^=[ mkfw_window_enable_drop ]===================================================================[=]
 MKFW_API void mkfw_window_enable_drop(struct mkfw_window *state, uint8_t enable) {
 	if(enable) {
 		Atom version = 5;
-		XChangeProperty(PLATFORM(state)->display, PLATFORM(state)->window, PLATFORM(state)->xdnd_aware, XA_ATOM, 32, PropModeReplace, (uint8_t *)&version, 1);
+		XChangeProperty(PLATFORM(state)->display, PLATFORM(state)->window, X11_ATOM(state, XDND_AWARE), XA_ATOM, 32, PropModeReplace, (uint8_t *)&version, 1);
 	} else {
-		XDeleteProperty(PLATFORM(state)->display, PLATFORM(state)->window, PLATFORM(state)->xdnd_aware);
+		XDeleteProperty(PLATFORM(state)->display, PLATFORM(state)->window, X11_ATOM(state, XDND_AWARE));
 	}
-	XFlush(PLATFORM(state)->display);
+	x11_flush(state->context);
 }
 
 // [=]===^=[ xdnd_percent_decode ]================================================================[=]
@@ -1280,14 +2717,17 @@ static void xdnd_parse_uri_list(struct mkfw_window *state, const char *data, uin
 	}
 }
 
-// [=]===^=[ mkfw_window_is_minimized ]=================================================================[=]
-MKFW_API uint32_t mkfw_window_is_minimized(struct mkfw_window *state) {
+// [=]===^=[ x11_read_wm_minimized ]=============================================================[=]
+// WM_STATE == IconicState.  Read only when the property changes; the
+// getter answers from the cached value.
+static uint8_t x11_read_wm_minimized(struct mkfw_window *state) {
 	Atom actual_type;
 	int actual_format;
 	unsigned long nitems, bytes_after;
 	unsigned char *data = 0;
-	XGetWindowProperty(PLATFORM(state)->display, PLATFORM(state)->window, PLATFORM(state)->wm_state, 0, 2, False, AnyPropertyType, &actual_type, &actual_format, &nitems, &bytes_after, &data);
-	uint32_t result = 0;
+	x11_round_trips(state->context, 1);
+	XGetWindowProperty(PLATFORM(state)->display, PLATFORM(state)->window, X11_ATOM(state, WM_STATE), 0, 2, False, AnyPropertyType, &actual_type, &actual_format, &nitems, &bytes_after, &data);
+	uint8_t result = 0;
 	if(data && nitems >= 1) {
 		long state_val = *(long *)data;
 		result = (state_val == 3) ? 1 : 0;
@@ -1298,23 +2738,25 @@ MKFW_API uint32_t mkfw_window_is_minimized(struct mkfw_window *state) {
 	return result;
 }
 
-// [=]===^=[ mkfw_window_is_maximized ]=================================================================[=]
-MKFW_API uint32_t mkfw_window_is_maximized(struct mkfw_window *state) {
+// [=]===^=[ x11_read_wm_maximized ]=============================================================[=]
+// Both _NET_WM_STATE_MAXIMIZED_HORZ and _VERT present in _NET_WM_STATE.
+static uint8_t x11_read_wm_maximized(struct mkfw_window *state) {
 	Display *dpy = PLATFORM(state)->display;
 	Atom actual_type;
 	int actual_format;
 	unsigned long nitems, bytes_after;
 	unsigned char *data = 0;
-	XGetWindowProperty(dpy, PLATFORM(state)->window, PLATFORM(state)->net_wm_state, 0, 1024, False, XA_ATOM, &actual_type, &actual_format, &nitems, &bytes_after, &data);
-	uint32_t result = 0;
+	x11_round_trips(state->context, 1);
+	XGetWindowProperty(dpy, PLATFORM(state)->window, X11_ATOM(state, NET_WM_STATE), 0, 1024, False, XA_ATOM, &actual_type, &actual_format, &nitems, &bytes_after, &data);
+	uint8_t result = 0;
 	if(data) {
 		Atom *atoms = (Atom *)data;
 		uint8_t has_h = 0, has_v = 0;
 		for(unsigned long i = 0; i < nitems; ++i) {
-			if(atoms[i] == PLATFORM(state)->net_wm_state_maximized_horz) {
+			if(atoms[i] == X11_ATOM(state, NET_WM_STATE_MAXIMIZED_HORZ)) {
 				has_h = 1;
 			}
-			if(atoms[i] == PLATFORM(state)->net_wm_state_maximized_vert) {
+			if(atoms[i] == X11_ATOM(state, NET_WM_STATE_MAXIMIZED_VERT)) {
 				has_v = 1;
 			}
 		}
@@ -1324,89 +2766,185 @@ MKFW_API uint32_t mkfw_window_is_maximized(struct mkfw_window *state) {
 	return result;
 }
 
+// [=]===^=[ mkfw_window_is_minimized ]=================================================================[=]
+MKFW_API uint32_t mkfw_window_is_minimized(struct mkfw_window *state) {
+	return PLATFORM(state)->cached_minimized;
+}
+
+// [=]===^=[ mkfw_window_is_maximized ]=================================================================[=]
+MKFW_API uint32_t mkfw_window_is_maximized(struct mkfw_window *state) {
+	return PLATFORM(state)->cached_maximized;
+}
+
 // Forward declaration so process_window_event can be called from mkfw_poll_events
 static void process_window_event(struct mkfw_window *state, XEvent *event_ptr);
 
 // [=]===^=[ find_window_for_event ]==============================================================[=]
 static struct mkfw_window *find_window_for_event(struct mkfw_context *ctx, XEvent *event) {
-	for(uint32_t i = 0; i < ctx->window_count; ++i) {
-		if(PLATFORM(ctx->windows[i])->window == event->xany.window) {
-			return ctx->windows[i];
+	// XInput2 generic events have window == 0; deliver them to the window
+	// under the pointer, else the first window.
+	if(event->type == GenericEvent) {
+		if(CTX_PLATFORM(ctx)->pointer_window) {
+			return CTX_PLATFORM(ctx)->pointer_window;
 		}
+		return ctx->window_count > 0 ? ctx->windows[0] : 0;
 	}
-	// XInput2 generic events have window == 0; deliver them to the focused window
-	if(event->type == GenericEvent) {
+	return x11_window_map_find(ctx, event->xany.window);
+}
+
+// [=]===^=[ x11_dispatch_event ]=================================================================[=]
+static void x11_dispatch_event(struct mkfw_context *ctx, XEvent *event) {
+	// Monitor hotplug: RRScreenChangeNotify targets the root window and
+	// matches no mkfw window, so handle it before per-window dispatch.
+	if(CTX_PLATFORM(ctx)->xrandr_event_base >= 0 && event->type == CTX_PLATFORM(ctx)->xrandr_event_base + RRScreenChangeNotify) {
+		XRRUpdateConfiguration(event);
+		ctx->monitor_count = (uint32_t)mkfw_query_monitors_into(ctx);
+		if(ctx->monitor_callback) {
+			ctx->monitor_callback(ctx);
+		}
+		// A display reconfigure is the realistic point at which the
+		// DPI-derived content scale shifts on X11; notify per window.
+		float scale = mkfw_compute_content_scale(CTX_PLATFORM(ctx)->display);
 		for(uint32_t i = 0; i < ctx->window_count; ++i) {
-			if(PLATFORM(ctx->windows[i])->in_window) {
-				return ctx->windows[i];
+			struct mkfw_window *w = ctx->windows[i];
+			if(w->content_scale_callback && scale != PLATFORM(w)->last_content_scale) {
+				PLATFORM(w)->last_content_scale = scale;
+				w->content_scale_callback(w, scale);
 			}
 		}
-		if(ctx->window_count > 0) {
-			return ctx->windows[0];
+		return;
+	}
+
+	// GLX_INTEL_swap_event: one per completed swap, sent for the drawable.
+	if(CTX_PLATFORM(ctx)->present_source == MKFW_PRESENT_INTEL && event->type == CTX_PLATFORM(ctx)->glx_event_base + GLX_BufferSwapComplete) {
+		GLXBufferSwapComplete *swap = (GLXBufferSwapComplete *)event;
+		struct mkfw_window *w = x11_window_map_find(ctx, swap->drawable);
+		if(w) {
+			mkfw_present_record(&PLATFORM(w)->present, (uint64_t)swap->ust * 1000, (uint64_t)swap->msc, (uint64_t)swap->sbc);
+		}
+		return;
+	}
+
+	// Keyboard remaps go to every client with no window of ours attached.
+	if(event->type == MappingNotify) {
+		XRefreshKeyboardMapping(&event->xmapping);
+		if(event->xmapping.request == MappingKeyboard || event->xmapping.request == MappingModifier) {
+			x11_build_keymap(ctx);
 		}
+		return;
 	}
-	return 0;
+
+	struct mkfw_window *target = find_window_for_event(ctx, event);
+	if(target) {
+		process_window_event(target, event);
+	}
+}
+
+// [=]===^=[ x11_flush_pointer_warps ]============================================================[=]
+// Recentres locked cursors flagged during this pump.  Nothing waits on the
+// warp: the MotionNotify it produces arrives in a later pump, already at
+// the centre, so it does not flag another warp.
+static void x11_flush_pointer_warps(struct mkfw_context *ctx) {
+	if(!CTX_PLATFORM(ctx)->warp_pending) {
+		return;
+	}
+	CTX_PLATFORM(ctx)->warp_pending = 0;
+	for(uint32_t i = 0; i < ctx->window_count; ++i) {
+		struct mkfw_window *w = ctx->windows[i];
+		if(!PLATFORM(w)->warp_pending) {
+			continue;
+		}
+		PLATFORM(w)->warp_pending = 0;
+		int32_t center_x = PLATFORM(w)->cached_width / 2;
+		int32_t center_y = PLATFORM(w)->cached_height / 2;
+		XWarpPointer(PLATFORM(w)->display, None, PLATFORM(w)->window, 0, 0, 0, 0, center_x, center_y);
+		PLATFORM(w)->last_mouse_x = center_x;
+		PLATFORM(w)->last_mouse_y = center_y;
+	}
+	XFlush(CTX_PLATFORM(ctx)->display);
+}
+
+// [=]===^=[ mkfw_next_event ]====================================================================[=]
+// Pop the oldest queued input record (MKFW_INIT_EVENT_QUEUE).  Returns 1
+// and fills *out, or 0 when the queue is empty or queued mode is off.
+// Lock-free and safe against a concurrent mkfw_poll_events on another
+// thread; only one thread may consume at a time.
+MKFW_API uint32_t mkfw_next_event(struct mkfw_context *ctx, struct mkfw_event *out) {
+	return mkfw_event_ring_pop(&ctx->event_queue, out);
+}
+
+// [=]===^=[ mkfw_next_raw_event ]================================================================[=]
+// Pop the oldest raw input record (MKFW_INIT_INPUT_THREAD): a
+// MKFW_EVENT_MOUSE_DELTA, MKFW_EVENT_MOUSE_BUTTON or MKFW_EVENT_SCROLL
+// with window == 0.  Returns 1 and fills *out, or 0 when nothing is
+// pending or the input thread is not running.  Never blocks; only one
+// thread may consume at a time.
+MKFW_API uint32_t mkfw_next_raw_event(struct mkfw_context *ctx, struct mkfw_event *out) {
+	return mkfw_event_ring_pop(&ctx->raw_input, out);
 }
 
 // [=]===^=[ mkfw_poll_events ]===================================================================[=]
+// Drains the queue in batches: one flushing XEventsQueued up front, then
+// XNextEvent for exactly that many events before asking again.  Re-checks
+// use QueuedAfterReading, which only touches the socket once the local
+// queue is empty, instead of a locked XPending round per event.
 MKFW_API void mkfw_poll_events(struct mkfw_context *ctx) {
 	if(!ctx || !CTX_PLATFORM(ctx)->display) {
 		return;
 	}
+	X11_CHECK_THREAD(ctx);
+	x11_loader_reap(ctx, 0);
+	struct mkfw_stats *stats = &ctx->stats;
+	stats->round_trips_last_frame = (uint32_t)(stats->round_trips - stats->round_trips_frame_mark);
+	stats->round_trips_frame_mark = stats->round_trips;
+
+	x11_window_request_step(ctx);
+
+	Display *dpy = CTX_PLATFORM(ctx)->display;
 	XEvent event;
-	while(XPending(CTX_PLATFORM(ctx)->display)) {
-		XNextEvent(CTX_PLATFORM(ctx)->display, &event);
-
-		// Monitor hotplug: RRScreenChangeNotify targets the root window and
-		// matches no mkfw window, so handle it before per-window dispatch.
-		if(CTX_PLATFORM(ctx)->xrandr_event_base >= 0 && event.type == CTX_PLATFORM(ctx)->xrandr_event_base + RRScreenChangeNotify) {
-			XRRUpdateConfiguration(&event);
-			ctx->monitor_count = (uint32_t)mkfw_query_monitors_into(ctx);
-			if(ctx->monitor_callback) {
-				ctx->monitor_callback(ctx);
-			}
-			// A display reconfigure is the realistic point at which the
-			// DPI-derived content scale shifts on X11; notify per window.
-			float scale = mkfw_compute_content_scale(CTX_PLATFORM(ctx)->display);
-			for(uint32_t i = 0; i < ctx->window_count; ++i) {
-				struct mkfw_window *w = ctx->windows[i];
-				if(w->content_scale_callback && scale != PLATFORM(w)->last_content_scale) {
-					PLATFORM(w)->last_content_scale = scale;
-					w->content_scale_callback(w, scale);
-				}
-			}
-			continue;
+	uint64_t deadline = ctx->pump_budget_ns ? mkfw_get_time() + ctx->pump_budget_ns : 0;
+	uint32_t handled = 0;
+	int32_t pending = XEventsQueued(dpy, QueuedAfterFlush);
+	while(pending > 0) {
+		XNextEvent(dpy, &event);
+		x11_dispatch_event(ctx, &event);
+		if(mkfw_pump_budget_spent(ctx, ++handled, deadline)) {
+			break;
 		}
-
-		struct mkfw_window *target = find_window_for_event(ctx, &event);
-		if(target) {
-			process_window_event(target, &event);
+		// Recount rather than count down: a callback may have pulled queued
+		// events itself (the clipboard's XCheckTypedWindowEvent), and a stale
+		// count would leave XNextEvent blocking the pump.  QueuedAlready only
+		// reads the queue length.
+		pending = XEventsQueued(dpy, QueuedAlready);
+		if(pending == 0) {
+			pending = XEventsQueued(dpy, QueuedAfterReading);
+		}
+	}
+	if(ctx->flags & MKFW_INIT_COALESCE_MOTION) {
+		for(uint32_t i = 0; i < ctx->window_count; ++i) {
+			mkfw_delta_flush(ctx->windows[i], &PLATFORM(ctx->windows[i])->coalesced_delta);
 		}
 	}
+	x11_flush_pointer_warps(ctx);
 }
 
 // [=]===^=[ process_window_event ]===============================================================[=]
 static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 	XEvent event = *event_ptr;
 	{
+		// Merged raw motion goes out ahead of any other input that follows
+		// it; core motion carries positions only and does not split a merge.
+		if(PLATFORM(state)->coalesced_delta.pending && event.type != GenericEvent && event.type != MotionNotify) {
+			mkfw_delta_flush(state, &PLATFORM(state)->coalesced_delta);
+		}
+
 		// Handle XInput2 generic events if relevant
 		if(event.type == GenericEvent && PLATFORM(state)->in_window) {
 			if(event.xcookie.extension == PLATFORM(state)->xi_opcode && XGetEventData(PLATFORM(state)->display, &event.xcookie)) {
 				if(event.xcookie.evtype == XI_RawMotion) {
 					XIRawEvent* re = (XIRawEvent*)event.xcookie.data;
-					double dx = 0.0;
-					double dy = 0.0;
-
-					int idx = 0;
-					int nValuators = re->valuators.mask_len * 8;
-					for(int i = 0; i < nValuators; i++) {
-						if(XIMaskIsSet(re->valuators.mask, i)) {
-							double val = re->raw_values[idx++];
-
-							if(i == 0) { dx = val; }
-							if(i == 1) { dy = val; }
-						}
-					}
+					double dx, dy;
+					x11_raw_motion_delta(re, &dx, &dy);
 
 					if(PLATFORM(state)->cursor_locked) {
 						if(dx * dx + dy * dy < 0.1) {
@@ -1422,8 +2960,11 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 					PLATFORM(state)->accumulated_dx += dx * PLATFORM(state)->mouse_sensitivity;
 					PLATFORM(state)->accumulated_dy += dy * PLATFORM(state)->mouse_sensitivity;
 
-					if(state->mouse_move_delta_callback) {
-						state->mouse_move_delta_callback(state, (int)dx, (int)dy);
+					uint64_t delta_time = x11_server_time_to_ns(state->context, re->time);
+					if(state->context->flags & MKFW_INIT_COALESCE_MOTION) {
+						mkfw_delta_add(&PLATFORM(state)->coalesced_delta, delta_time, dx, dy);
+					} else {
+						mkfw_emit_mouse_delta(state, delta_time, (int)dx, (int)dy);
 					}
 				}
 				XFreeEventData(PLATFORM(state)->display, &event.xcookie);
@@ -1443,17 +2984,21 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 			case EnterNotify: {
 				PLATFORM(state)->in_window = true;
 				state->mouse_in_window = 1;
-				if(state->cursor_enter_callback) {
-					state->cursor_enter_callback(state, 1);
-				}
+				state->mouse_x = event.xcrossing.x;
+				state->mouse_y = event.xcrossing.y;
+				WIN_CTX_PLATFORM(state)->pointer_window = state;
+				mkfw_emit_cursor_enter(state, x11_server_time_to_ns(state->context, event.xcrossing.time), 1);
 			} break;
 
 			case LeaveNotify: {
 				PLATFORM(state)->in_window = false;
 				state->mouse_in_window = 0;
-				if(state->cursor_enter_callback) {
-					state->cursor_enter_callback(state, 0);
+				state->mouse_x = event.xcrossing.x;
+				state->mouse_y = event.xcrossing.y;
+				if(WIN_CTX_PLATFORM(state)->pointer_window == state) {
+					WIN_CTX_PLATFORM(state)->pointer_window = 0;
 				}
+				mkfw_emit_cursor_enter(state, x11_server_time_to_ns(state->context, event.xcrossing.time), 0);
 			} break;
 
 			case FocusIn: {
@@ -1461,9 +3006,8 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 				if(PLATFORM(state)->xic) {
 					XSetICFocus(PLATFORM(state)->xic);
 				}
-				if(state->focus_callback) {
-					state->focus_callback(state, 1);
-				}
+				x11_update_raw_motion(state->context);
+				mkfw_emit_focus(state, mkfw_get_time(), 1);
 			} break;
 
 			case FocusOut: {
@@ -1471,16 +3015,16 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 				if(PLATFORM(state)->xic) {
 					XUnsetICFocus(PLATFORM(state)->xic);
 				}
-				if(state->focus_callback) {
-					state->focus_callback(state, 0);
-				}
+				memset(PLATFORM(state)->keys_down, 0, sizeof(PLATFORM(state)->keys_down));
+				x11_update_raw_motion(state->context);
+				mkfw_emit_focus(state, mkfw_get_time(), 0);
 			} break;
 
 			case KeyPress: {
-				x11_update_scancode(state, event.xkey.keycode, 1);
-				map_x11_keysym(state, XLookupKeysym(&event.xkey, 0), 1);
+				uint64_t key_time = x11_server_time_to_ns(state->context, event.xkey.time);
+				x11_handle_key(state, event.xkey.keycode, 1, key_time);
 
-				if(state->char_callback) {
+				if(state->char_callback || state->context->event_queue.events) {
 					char buf[64];
 					KeySym keysym;
 					Status xim_status;
@@ -1531,7 +3075,7 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 								continue;
 							}
 							if(codepoint == 8 || codepoint >= 32) {
-								state->char_callback(state, codepoint);
+								mkfw_emit_char(state, key_time, codepoint);
 							}
 						}
 					}
@@ -1539,8 +3083,17 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 			} break;
 
 			case KeyRelease: {
-				x11_update_scancode(state, event.xkey.keycode, 0);
-				map_x11_keysym(state, XLookupKeysym(&event.xkey, 0), 0);
+				// Legacy auto-repeat: a release immediately followed by a press
+				// of the same key with the same timestamp is a repeat, not a
+				// real release.  The press is then reported as MKFW_REPEAT.
+				if(!WIN_CTX_PLATFORM(state)->detectable_repeat && XEventsQueued(PLATFORM(state)->display, QueuedAfterReading)) {
+					XEvent next;
+					XPeekEvent(PLATFORM(state)->display, &next);
+					if(next.type == KeyPress && next.xkey.window == event.xkey.window && next.xkey.keycode == event.xkey.keycode && next.xkey.time == event.xkey.time) {
+						break;
+					}
+				}
+				x11_handle_key(state, event.xkey.keycode, 0, x11_server_time_to_ns(state->context, event.xkey.time));
 			} break;
 
 			case SelectionRequest: {
@@ -1555,12 +3108,12 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 				reply.property = None;
 
 				if(PLATFORM(state)->clipboard_text) {
-					if(req->target == PLATFORM(state)->targets_atom) {
-						Atom targets[] = { PLATFORM(state)->utf8_string_atom, XA_STRING };
+					if(req->target == X11_ATOM(state, TARGETS)) {
+						Atom targets[] = { X11_ATOM(state, UTF8_STRING), XA_STRING };
 						XChangeProperty(PLATFORM(state)->display, req->requestor, req->property, XA_ATOM, 32, PropModeReplace, (uint8_t *)targets, 2);
 						reply.property = req->property;
 
-					} else if(req->target == PLATFORM(state)->utf8_string_atom || req->target == XA_STRING) {
+					} else if(req->target == X11_ATOM(state, UTF8_STRING) || req->target == XA_STRING) {
 						XChangeProperty(PLATFORM(state)->display, req->requestor, req->property, req->target, 8, PropModeReplace, (uint8_t *)PLATFORM(state)->clipboard_text, strlen(PLATFORM(state)->clipboard_text));
 						reply.property = req->property;
 					}
@@ -1571,26 +3124,21 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 
 			case ButtonPress: {
 				uint32_t xbtn = event.xbutton.button;
+				state->mouse_x = event.xbutton.x;
+				state->mouse_y = event.xbutton.y;
+				uint64_t button_time = x11_server_time_to_ns(state->context, event.xbutton.time);
 
 				if(xbtn == 4) {
-					if(state->scroll_callback) {
-						state->scroll_callback(state, 0.0, 1.0);
-					}
+					mkfw_emit_scroll(state, button_time, 0.0, 1.0);
 
 				} else if(xbtn == 5) {
-					if(state->scroll_callback) {
-						state->scroll_callback(state, 0.0, -1.0);
-					}
+					mkfw_emit_scroll(state, button_time, 0.0, -1.0);
 
 				} else if(xbtn == 6) {
-					if(state->scroll_callback) {
-						state->scroll_callback(state, -1.0, 0.0);
-					}
+					mkfw_emit_scroll(state, button_time, -1.0, 0.0);
 
 				} else if(xbtn == 7) {
-					if(state->scroll_callback) {
-						state->scroll_callback(state, 1.0, 0.0);
-					}
+					mkfw_emit_scroll(state, button_time, 1.0, 0.0);
 
 				} else {
 					uint8_t mapped = 0;
@@ -1608,14 +3156,14 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 						break;
 					}
 					state->mouse_buttons[mapped] = 1;
-					if(state->mouse_button_callback) {
-						state->mouse_button_callback(state, mapped, MKFW_PRESSED);
-					}
+					mkfw_emit_mouse_button(state, button_time, mapped, MKFW_PRESSED);
 				}
 			} break;
 
 			case ButtonRelease: {
 				uint32_t xbtn = event.xbutton.button;
+				state->mouse_x = event.xbutton.x;
+				state->mouse_y = event.xbutton.y;
 				uint8_t mapped = 0;
 				if(xbtn == 1) {
 					mapped = MKFW_MOUSE_LEFT;
@@ -1631,9 +3179,7 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 					break;
 				}
 				state->mouse_buttons[mapped] = 0;
-				if(state->mouse_button_callback) {
-					state->mouse_button_callback(state, mapped, MKFW_RELEASED);
-				}
+				mkfw_emit_mouse_button(state, x11_server_time_to_ns(state->context, event.xbutton.time), mapped, MKFW_RELEASED);
 			} break;
 
 			case MotionNotify: {
@@ -1645,20 +3191,18 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 					state->mouse_x = event.xmotion.x;
 					state->mouse_y = event.xmotion.y;
 
-					if(state->cursor_pos_callback) {
-						state->cursor_pos_callback(state, event.xmotion.x, event.xmotion.y);
-					}
+					mkfw_emit_cursor_pos(state, x11_server_time_to_ns(state->context, event.xmotion.time), event.xmotion.x, event.xmotion.y);
 
+					// Hidden+locked FPS cursor: deltas come from raw motion and
+					// the grab confines the pointer, so it only needs pulling
+					// back once it leaves the middle half of the window, and at
+					// most once per pump (see x11_flush_pointer_warps).
 					if(PLATFORM(state)->cursor_locked && !PLATFORM(state)->cursor_visible) {
-						XWindowAttributes attrs;
-						XGetWindowAttributes(PLATFORM(state)->display, PLATFORM(state)->window, &attrs);
-						int center_x = attrs.width / 2;
-						int center_y = attrs.height / 2;
-						if (event.xmotion.x != center_x || event.xmotion.y != center_y) { // Only re-center hidden+locked FPS cursors
-							XWarpPointer(PLATFORM(state)->display, None, PLATFORM(state)->window, 0, 0, 0, 0, center_x, center_y);
-							XSync(PLATFORM(state)->display, False);
-							PLATFORM(state)->last_mouse_x = center_x;
-							PLATFORM(state)->last_mouse_y = center_y;
+						int32_t off_x = event.xmotion.x - PLATFORM(state)->cached_width / 2;
+						int32_t off_y = event.xmotion.y - PLATFORM(state)->cached_height / 2;
+						if(abs(off_x) > PLATFORM(state)->cached_width / 4 || abs(off_y) > PLATFORM(state)->cached_height / 4) {
+							PLATFORM(state)->warp_pending = 1;
+							WIN_CTX_PLATFORM(state)->warp_pending = 1;
 						}
 					}
 				}
@@ -1668,12 +3212,21 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 				int new_width  = event.xconfigure.width;
 				int new_height = event.xconfigure.height;
 
-				// Absolute position: xconfigure.x/y are parent-relative under
-				// reparenting WMs, so translate the origin to the root.
+				PLATFORM(state)->cached_width  = new_width;
+				PLATFORM(state)->cached_height = new_height;
+
+				// Absolute position: a real ConfigureNotify is parent-relative,
+				// which is root-relative only while we are not reparented.  WMs
+				// send a synthetic ConfigureNotify in root coordinates whenever
+				// the frame moves (ICCCM 4.1.5), so no translation is needed.
+				if(event.xconfigure.send_event || !PLATFORM(state)->reparented) {
+					PLATFORM(state)->cached_x = event.xconfigure.x;
+					PLATFORM(state)->cached_y = event.xconfigure.y;
+					PLATFORM(state)->have_cached_pos = 1;
+				}
 				if(state->window_pos_callback) {
-					Window child;
-					int abs_x = 0, abs_y = 0;
-					XTranslateCoordinates(PLATFORM(state)->display, PLATFORM(state)->window, DefaultRootWindow(PLATFORM(state)->display), 0, 0, &abs_x, &abs_y, &child);
+					int32_t abs_x, abs_y;
+					x11_window_position(state, &abs_x, &abs_y);
 					if(!PLATFORM(state)->have_last_pos || abs_x != PLATFORM(state)->last_pos_x || abs_y != PLATFORM(state)->last_pos_y) {
 						PLATFORM(state)->last_pos_x = abs_x;
 						PLATFORM(state)->last_pos_y = abs_y;
@@ -1688,21 +3241,25 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 				PLATFORM(state)->last_framebuffer_width  = new_width;
 				PLATFORM(state)->last_framebuffer_height = new_height;
 
-				if(state->framebuffer_callback) {
-					state->framebuffer_callback(state, PLATFORM(state)->last_framebuffer_width, PLATFORM(state)->last_framebuffer_height, PLATFORM(state)->aspect_ratio);
-				}
+				mkfw_emit_framebuffer_size(state, mkfw_get_time(), PLATFORM(state)->last_framebuffer_width, PLATFORM(state)->last_framebuffer_height, PLATFORM(state)->aspect_ratio);
+			} break;
+
+			case ReparentNotify: {
+				// The offset inside a new frame is unknown until the WM's
+				// synthetic ConfigureNotify; position falls back to one
+				// translation until then.
+				PLATFORM(state)->reparented = event.xreparent.parent != DefaultRootWindow(PLATFORM(state)->display);
+				PLATFORM(state)->have_cached_pos = 0;
 			} break;
 
 			case ClientMessage: {
 				Atom msg_type = event.xclient.message_type;
 
-				if((Atom)event.xclient.data.l[0] == PLATFORM(state)->wm_delete_window) {
+				if((Atom)event.xclient.data.l[0] == X11_ATOM(state, WM_DELETE_WINDOW)) {
 					PLATFORM(state)->should_close = 1;
-					if(state->close_callback) {
-						state->close_callback(state);
-					}
+					mkfw_emit_close(state, mkfw_get_time());
 
-				} else if(msg_type == PLATFORM(state)->xdnd_enter) {
+				} else if(msg_type == X11_ATOM(state, XDND_ENTER)) {
 					PLATFORM(state)->xdnd_source = (Window)event.xclient.data.l[0];
 					PLATFORM(state)->xdnd_has_uri_list = 0;
 					uint8_t more_than_three = (event.xclient.data.l[1] >> 0) & 1;
@@ -1711,11 +3268,12 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 						int actual_format;
 						unsigned long nitems, bytes_after;
 						unsigned char *type_data = 0;
-						XGetWindowProperty(PLATFORM(state)->display, PLATFORM(state)->xdnd_source, PLATFORM(state)->xdnd_type_list, 0, 1024, False, XA_ATOM, &actual_type, &actual_format, &nitems, &bytes_after, &type_data);
+						x11_round_trips(state->context, 1);
+						XGetWindowProperty(PLATFORM(state)->display, PLATFORM(state)->xdnd_source, X11_ATOM(state, XDND_TYPE_LIST), 0, 1024, False, XA_ATOM, &actual_type, &actual_format, &nitems, &bytes_after, &type_data);
 						if(type_data) {
 							Atom *types = (Atom *)type_data;
 							for(unsigned long ti = 0; ti < nitems; ++ti) {
-								if(types[ti] == PLATFORM(state)->text_uri_list) {
+								if(types[ti] == X11_ATOM(state, TEXT_URI_LIST)) {
 									PLATFORM(state)->xdnd_has_uri_list = 1;
 									break;
 								}
@@ -1724,19 +3282,19 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 						}
 					} else {
 						for(uint32_t ti = 0; ti < 3; ++ti) {
-							if((Atom)event.xclient.data.l[2 + ti] == PLATFORM(state)->text_uri_list) {
+							if((Atom)event.xclient.data.l[2 + ti] == X11_ATOM(state, TEXT_URI_LIST)) {
 								PLATFORM(state)->xdnd_has_uri_list = 1;
 								break;
 							}
 						}
 					}
 
-				} else if(msg_type == PLATFORM(state)->xdnd_position) {
+				} else if(msg_type == X11_ATOM(state, XDND_POSITION)) {
 					XEvent reply;
 					memset(&reply, 0, sizeof(reply));
 					reply.xclient.type = ClientMessage;
 					reply.xclient.window = PLATFORM(state)->xdnd_source;
-					reply.xclient.message_type = PLATFORM(state)->xdnd_status;
+					reply.xclient.message_type = X11_ATOM(state, XDND_STATUS);
 					reply.xclient.format = 32;
 					reply.xclient.data.l[0] = (long)PLATFORM(state)->window;
 					reply.xclient.data.l[1] = PLATFORM(state)->xdnd_has_uri_list ? 1 : 0;
@@ -1746,20 +3304,20 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 					XSendEvent(PLATFORM(state)->display, PLATFORM(state)->xdnd_source, False, NoEventMask, &reply);
 					XFlush(PLATFORM(state)->display);
 
-				} else if(msg_type == PLATFORM(state)->xdnd_leave) {
+				} else if(msg_type == X11_ATOM(state, XDND_LEAVE)) {
 					PLATFORM(state)->xdnd_source = 0;
 					PLATFORM(state)->xdnd_has_uri_list = 0;
 
-				} else if(msg_type == PLATFORM(state)->xdnd_drop) {
+				} else if(msg_type == X11_ATOM(state, XDND_DROP)) {
 					if(PLATFORM(state)->xdnd_has_uri_list) {
-						XConvertSelection(PLATFORM(state)->display, PLATFORM(state)->xdnd_selection, PLATFORM(state)->text_uri_list, PLATFORM(state)->xdnd_selection, PLATFORM(state)->window, CurrentTime);
+						XConvertSelection(PLATFORM(state)->display, X11_ATOM(state, XDND_SELECTION), X11_ATOM(state, TEXT_URI_LIST), X11_ATOM(state, XDND_SELECTION), PLATFORM(state)->window, CurrentTime);
 						XFlush(PLATFORM(state)->display);
 					} else {
 						XEvent reply;
 						memset(&reply, 0, sizeof(reply));
 						reply.xclient.type = ClientMessage;
 						reply.xclient.window = PLATFORM(state)->xdnd_source;
-						reply.xclient.message_type = PLATFORM(state)->xdnd_finished;
+						reply.xclient.message_type = X11_ATOM(state, XDND_FINISHED);
 						reply.xclient.format = 32;
 						reply.xclient.data.l[0] = (long)PLATFORM(state)->window;
 						reply.xclient.data.l[1] = 0;
@@ -1772,12 +3330,13 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 			} break;
 
 			case SelectionNotify: {
-				if(event.xselection.selection == PLATFORM(state)->xdnd_selection) {
+				if(event.xselection.selection == X11_ATOM(state, XDND_SELECTION)) {
 					Atom actual_type;
 					int actual_format;
 					unsigned long nitems, bytes_after;
 					unsigned char *data = 0;
-					XGetWindowProperty(PLATFORM(state)->display, PLATFORM(state)->window, PLATFORM(state)->xdnd_selection, 0, 1024 * 1024, True, AnyPropertyType, &actual_type, &actual_format, &nitems, &bytes_after, &data);
+					x11_round_trips(state->context, 1);
+					XGetWindowProperty(PLATFORM(state)->display, PLATFORM(state)->window, X11_ATOM(state, XDND_SELECTION), 0, 1024 * 1024, True, AnyPropertyType, &actual_type, &actual_format, &nitems, &bytes_after, &data);
 					if(data) {
 						xdnd_parse_uri_list(state, (const char *)data, (uint32_t)(nitems * (actual_format / 8)));
 						XFree(data);
@@ -1787,7 +3346,7 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 					memset(&reply, 0, sizeof(reply));
 					reply.xclient.type = ClientMessage;
 					reply.xclient.window = PLATFORM(state)->xdnd_source;
-					reply.xclient.message_type = PLATFORM(state)->xdnd_finished;
+					reply.xclient.message_type = X11_ATOM(state, XDND_FINISHED);
 					reply.xclient.format = 32;
 					reply.xclient.data.l[0] = (long)PLATFORM(state)->window;
 					reply.xclient.data.l[1] = 1;
@@ -1800,17 +3359,21 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 			} break;
 
 			case PropertyNotify: {
-				if(!state->window_state_callback) {
-					break;
-				}
 				Atom prop = event.xproperty.atom;
-				if(prop == PLATFORM(state)->net_wm_state || prop == PLATFORM(state)->wm_state) {
-					uint8_t maximized = (uint8_t)mkfw_window_is_maximized(state);
-					uint8_t minimized = (uint8_t)mkfw_window_is_minimized(state);
-					if(maximized != PLATFORM(state)->last_maximized || minimized != PLATFORM(state)->last_minimized) {
-						PLATFORM(state)->last_maximized = maximized;
-						PLATFORM(state)->last_minimized = minimized;
-						state->window_state_callback(state, maximized, minimized);
+				if(prop == X11_ATOM(state, NET_WM_STATE) || prop == X11_ATOM(state, WM_STATE)) {
+					uint8_t maximized = PLATFORM(state)->cached_maximized;
+					uint8_t minimized = PLATFORM(state)->cached_minimized;
+					if(prop == X11_ATOM(state, WM_STATE)) {
+						minimized = x11_read_wm_minimized(state);
+					} else {
+						maximized = x11_read_wm_maximized(state);
+					}
+					if(maximized != PLATFORM(state)->cached_maximized || minimized != PLATFORM(state)->cached_minimized) {
+						PLATFORM(state)->cached_maximized = maximized;
+						PLATFORM(state)->cached_minimized = minimized;
+						if(state->window_state_callback) {
+							state->window_state_callback(state, maximized, minimized);
+						}
 					}
 				}
 			} break;
@@ -1818,9 +3381,94 @@ static void process_window_event(struct mkfw_window *state, XEvent *event_ptr) {
 	}
 }
 
+// [=]===^=[ x11_window_swap ]====================================================================[=]
+// Frame fences go into the current context, so they are only kept when
+// the window's own context is current.
+static void x11_window_swap(struct mkfw_window *state, uint32_t fence) {
+	PLATFORM(state)->present.submit_ns = mkfw_get_time();
+	glXSwapBuffers(PLATFORM(state)->display, PLATFORM(state)->window);
+
+	// Fence this frame, then wait for the one frames_in_flight swaps back:
+	// the driver can no longer queue frames far ahead of the display, and
+	// the caller samples input for the next frame as late as possible.
+	struct x11_mkfw_window *xw = PLATFORM(state);
+	struct x11_mkfw_context *xc = CTX_PLATFORM(state->context);
+	uint32_t frames = xw->options.frames_in_flight;
+	if(fence && frames && xw->has_sync && xc->glFenceSync) {
+		frames = frames < MKFW_MAX_FRAMES_IN_FLIGHT ? frames : MKFW_MAX_FRAMES_IN_FLIGHT;
+		void *oldest = xw->fences[xw->fence_head];
+		xw->fences[xw->fence_head] = xc->glFenceSync(MKFW_GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		xw->fence_head = (xw->fence_head + 1) % frames;
+		if(oldest) {
+			xc->glClientWaitSync(oldest, MKFW_GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ULL);
+			xc->glDeleteSync(oldest);
+		}
+	}
+
+	struct mkfw_present_stats *ps = &xw->present;
+	++ps->swaps;
+	if(xc->present_source == MKFW_PRESENT_CPU) {
+		mkfw_present_record(ps, mkfw_get_time(), 0, ps->swaps);
+	}
+}
+
+static void x11_swap_interval_apply(struct mkfw_window *state, int32_t interval);
+
 // [=]===^=[ mkfw_window_swap_buffers ]==================================================================[=]
 MKFW_API void mkfw_window_swap_buffers(struct mkfw_window *state) {
-	glXSwapBuffers(PLATFORM(state)->display, PLATFORM(state)->window);
+	X11_CHECK_THREAD(state->context);
+	struct x11_mkfw_window *xw = PLATFORM(state);
+	if(xw->swap_interval_known && xw->swap_interval_applied != xw->swap_interval) {
+		x11_swap_interval_apply(state, xw->swap_interval);
+	}
+	x11_window_swap(state, 1);
+}
+
+// [=]===^=[ mkfw_window_set_frames_in_flight ]===================================================[=]
+// Call on the thread that has the window's GL context current.
+MKFW_API void mkfw_window_set_frames_in_flight(struct mkfw_window *state, uint32_t frames) {
+	if(!state || !PLATFORM(state)->glctx) {
+		return;
+	}
+	x11_frame_fences_clear(state);
+	PLATFORM(state)->options.frames_in_flight = frames;
+}
+
+// [=]===^=[ mkfw_window_get_present_stats ]======================================================[=]
+// UST from OML and INTEL is taken as microseconds of CLOCK_MONOTONIC, which
+// is what Mesa and the NVIDIA driver report.
+MKFW_API uint32_t mkfw_window_get_present_stats(struct mkfw_window *state, struct mkfw_present_stats *out) {
+	if(!state || !out || !PLATFORM(state)->glctx) {
+		return 0;
+	}
+	struct x11_mkfw_context *xc = CTX_PLATFORM(state->context);
+	struct mkfw_present_stats *ps = &PLATFORM(state)->present;
+	if(xc->present_source == MKFW_PRESENT_OML) {
+		int64_t ust = 0, msc = 0, sbc = 0;
+		x11_round_trips(state->context, 1);
+		if(xc->glXGetSyncValuesOML(PLATFORM(state)->display, PLATFORM(state)->window, &ust, &msc, &sbc)) {
+			mkfw_present_record(ps, (uint64_t)ust * 1000, (uint64_t)msc, (uint64_t)sbc);
+		}
+	}
+	*out = *ps;
+	out->source = xc->present_source;
+	out->queue_depth = ps->swaps > ps->sbc ? (uint32_t)(ps->swaps - ps->sbc) : 0;
+	out->swaps -= PLATFORM(state)->swaps_base;
+	out->sbc = ps->sbc > PLATFORM(state)->swaps_base ? ps->sbc - PLATFORM(state)->swaps_base : 0;
+	return 1;
+}
+
+// [=]===^=[ mkfw_window_pace_frame ]=============================================================[=]
+// Spin for the last 500 us of the wait: nanosleep overshoots by tens of microseconds.
+MKFW_API uint64_t mkfw_window_pace_frame(struct mkfw_window *state, struct mkfw_frame_pacer *pacer) {
+	struct mkfw_present_stats ps;
+	if(!pacer || !mkfw_window_get_present_stats(state, &ps)) {
+		return mkfw_get_time();
+	}
+	int32_t x = 0, y = 0;
+	x11_window_position(state, &x, &y);
+	int32_t hz = mkfw_monitor_refresh_at(state->context, x + PLATFORM(state)->cached_width / 2, y + PLATFORM(state)->cached_height / 2);
+	return mkfw_pacer_wait(pacer, &ps, hz, 500000);
 }
 
 // [=]===^=[ x11_apply_size_hints ]===============================================================[=]
@@ -1872,20 +3520,21 @@ MKFW_API void mkfw_window_set_aspect_ratio(struct mkfw_window *state, int32_t nu
 
 // [=]===^=[ mkfw_window_set_title ]==============================================================[=]
 MKFW_API void mkfw_window_set_title(struct mkfw_window *state, const char *title) {
+	X11_CHECK_THREAD(state->context);
 	if(!title) {
 		return;
 	}
 	XStoreName(PLATFORM(state)->display, PLATFORM(state)->window, title);
 
 	// Set _NET_WM_NAME for modern window managers
-	Atom net_wm_name = XInternAtom(PLATFORM(state)->display, "_NET_WM_NAME", 0);
-	Atom utf8_string = XInternAtom(PLATFORM(state)->display, "UTF8_STRING", 0);
+	Atom net_wm_name = X11_ATOM(state, NET_WM_NAME);
+	Atom utf8_string = X11_ATOM(state, UTF8_STRING);
 
 	if(net_wm_name && utf8_string) {
 		XChangeProperty(PLATFORM(state)->display, PLATFORM(state)->window, net_wm_name, utf8_string, 8, PropModeReplace, (uint8_t *)title, strlen(title));
 	}
 
-	XFlush(PLATFORM(state)->display);
+	x11_flush(state->context);
 }
 
 // [=]===^=[ mkfw_window_set_resizable ]==========================================================[=]
@@ -1893,7 +3542,7 @@ MKFW_API void mkfw_window_set_resizable(struct mkfw_window *state, int32_t resiz
 	if(resizable) {
 		// Restore caller-supplied size/aspect constraints, if any.
 		x11_apply_size_hints(state);
-		XFlush(PLATFORM(state)->display);
+		x11_flush(state->context);
 		return;
 	}
 
@@ -1904,18 +3553,15 @@ MKFW_API void mkfw_window_set_resizable(struct mkfw_window *state, int32_t resiz
 		return;
 	}
 
-	XWindowAttributes attrs;
-	XGetWindowAttributes(PLATFORM(state)->display, PLATFORM(state)->window, &attrs);
-
 	hints->flags = PMinSize | PMaxSize;
-	hints->min_width  = attrs.width;
-	hints->min_height = attrs.height;
-	hints->max_width  = attrs.width;
-	hints->max_height = attrs.height;
+	hints->min_width  = PLATFORM(state)->cached_width;
+	hints->min_height = PLATFORM(state)->cached_height;
+	hints->max_width  = PLATFORM(state)->cached_width;
+	hints->max_height = PLATFORM(state)->cached_height;
 
 	XSetWMNormalHints(PLATFORM(state)->display, PLATFORM(state)->window, hints);
 	XFree(hints);
-	XFlush(PLATFORM(state)->display);
+	x11_flush(state->context);
 }
 
 // [=]===^=[ mkfw_window_set_decorated ]==========================================================[=]
@@ -1927,69 +3573,174 @@ MKFW_API void mkfw_window_set_decorated(struct mkfw_window *state, int32_t decor
 		long input_mode;
 		unsigned long status;
 	};
-	Atom motif = XInternAtom(PLATFORM(state)->display, "_MOTIF_WM_HINTS", False);
+	Atom motif = X11_ATOM(state, MOTIF_WM_HINTS);
 	struct motif_hints hints = {0};
 	hints.flags = 2;
 	hints.decorations = decorated ? 1 : 0;
 	XChangeProperty(PLATFORM(state)->display, PLATFORM(state)->window, motif, motif, 32, PropModeReplace, (unsigned char *)&hints, 5);
-	XFlush(PLATFORM(state)->display);
+	x11_flush(state->context);
 }
 
 // [=]===^=[ mkfw_window_set_opacity ]============================================================[=]
 MKFW_API void mkfw_window_set_opacity(struct mkfw_window *state, float opacity) {
 	Display *dpy = PLATFORM(state)->display;
-	Atom net_wm_opacity = XInternAtom(dpy, "_NET_WM_WINDOW_OPACITY", False);
+	Atom net_wm_opacity = X11_ATOM(state, NET_WM_WINDOW_OPACITY);
 	if(opacity >= 1.0f) {
 		XDeleteProperty(dpy, PLATFORM(state)->window, net_wm_opacity);
 	} else {
 		uint32_t val = (uint32_t)((double)opacity * (double)0xffffffff);
 		XChangeProperty(dpy, PLATFORM(state)->window, net_wm_opacity, XA_CARDINAL, 32, PropModeReplace, (unsigned char *)&val, 1);
 	}
-	XFlush(dpy);
+	x11_flush(state->context);
 }
 
 // [=]===^=[ mkfw_window_set_size ]===============================================================[=]
 MKFW_API void mkfw_window_set_size(struct mkfw_window *state, int32_t width, int32_t height) {
+	X11_CHECK_THREAD(state->context);
 	XResizeWindow(PLATFORM(state)->display, PLATFORM(state)->window, width, height);
-	XFlush(PLATFORM(state)->display);
+	x11_flush(state->context);
 }
 
 // [=]===^=[ mkfw_window_get_framebuffer_size ]==========================================================[=]
 MKFW_API void mkfw_window_get_framebuffer_size(struct mkfw_window *state, int32_t *width, int32_t *height) {
-	Window root;
-	int x, y;
-	unsigned int w, h, border, depth;
-	XGetGeometry(PLATFORM(state)->display, PLATFORM(state)->window, &root, &x, &y, &w, &h, &border, &depth);
 	if(width) {
-		*width = (int32_t)w;
+		*width = PLATFORM(state)->cached_width;
 	}
 	if(height) {
-		*height = (int32_t)h;
+		*height = PLATFORM(state)->cached_height;
 	}
 }
 
-// [=]===^=[ mkfw_window_set_swap_interval ]==============================================================[=]
-MKFW_API void mkfw_window_set_swap_interval(struct mkfw_window *state, uint32_t interval) {
-	typedef int (*PFNGLXSWAPINTERVALEXTPROC)(Display*, GLXDrawable, int);
-	PFNGLXSWAPINTERVALEXTPROC glXSwapIntervalEXT = (PFNGLXSWAPINTERVALEXTPROC)glXGetProcAddress((const unsigned char *)"glXSwapIntervalEXT");
+// [=]===^=[ x11_swap_interval_mesa ]=============================================================[=]
+// MESA_swap_control acts on the current drawable; make the window current
+// for the call if it is not.
+static int32_t x11_swap_interval_mesa(struct mkfw_window *state, int32_t set, int32_t interval) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(state->context);
+	GLXContext prev_ctx = glXGetCurrentContext ? glXGetCurrentContext() : 0;
+	GLXDrawable prev_drawable = glXGetCurrentDrawable();
+	uint32_t switched = prev_ctx != PLATFORM(state)->glctx || prev_drawable != PLATFORM(state)->window;
+	if(switched) {
+		glXMakeCurrent(PLATFORM(state)->display, PLATFORM(state)->window, PLATFORM(state)->glctx);
+	}
+	int32_t result = set ? xc->glXSwapIntervalMESA((unsigned int)interval) : xc->glXGetSwapIntervalMESA();
+	if(switched) {
+		glXMakeCurrent(PLATFORM(state)->display, prev_drawable, prev_ctx);
+	}
+	return result;
+}
+
+// [=]===^=[ x11_swap_interval_apply ]============================================================[=]
+static void x11_swap_interval_apply(struct mkfw_window *state, int32_t interval) {
+	struct x11_mkfw_context *xc = CTX_PLATFORM(state->context);
+	if(xc->glXSwapIntervalEXT) {
+		xc->glXSwapIntervalEXT(PLATFORM(state)->display, PLATFORM(state)->window, interval);
+	} else if(xc->glXSwapIntervalMESA) {
+		x11_swap_interval_mesa(state, 1, interval);
+	}
+	PLATFORM(state)->swap_interval_applied = interval;
+}
 
-	if(glXSwapIntervalEXT) {
-		glXSwapIntervalEXT(PLATFORM(state)->display, glXGetCurrentDrawable(), interval);
+// [=]===^=[ mkfw_window_set_swap_interval ]==============================================================[=]
+// A negative interval asks for late swaps to tear (EXT_swap_control_tear);
+// without it the interval is used as positive.
+MKFW_API void mkfw_window_set_swap_interval(struct mkfw_window *state, int32_t interval) {
+	if(!state || !PLATFORM(state)->glctx) {
+		return;
 	}
+	struct x11_mkfw_context *xc = CTX_PLATFORM(state->context);
+	if(interval < 0 && !(xc->swap_caps & MKFW_SWAP_CAP_TEAR)) {
+		interval = -interval;
+	}
+	PLATFORM(state)->swap_interval = interval;
+	PLATFORM(state)->swap_interval_known = 1;
+	x11_swap_interval_apply(state, interval);
 }
 
 // [=]===^=[ mkfw_window_get_swap_interval ]==============================================================[=]
+// Negative when late swaps tear.  While mkfw_present_windows runs the
+// window unthrottled this is the interval the caller asked for, not the
+// 0 on the drawable.
 MKFW_API int32_t mkfw_window_get_swap_interval(struct mkfw_window *state) {
-	typedef void (*PFNGLXQUERYDRAWABLEPROC)(Display *, GLXDrawable, int, unsigned int *);
-	PFNGLXQUERYDRAWABLEPROC pglXQueryDrawable = (PFNGLXQUERYDRAWABLEPROC)glXGetProcAddress((const unsigned char *)"glXQueryDrawable");
-	if(pglXQueryDrawable) {
+	if(!state || !PLATFORM(state)->glctx) {
+		return 0;
+	}
+	if(PLATFORM(state)->swap_interval_known && PLATFORM(state)->swap_interval_applied != PLATFORM(state)->swap_interval) {
+		return PLATFORM(state)->swap_interval;
+	}
+	struct x11_mkfw_context *xc = CTX_PLATFORM(state->context);
+	if(xc->glXSwapIntervalEXT) {
 		unsigned int interval = 0;
-		pglXQueryDrawable(PLATFORM(state)->display, PLATFORM(state)->window, 0x20f1, &interval);
-		return (int32_t)interval;
+		unsigned int tear = 0;
+		x11_round_trips(state->context, 1);
+		xc->glXQueryDrawable(PLATFORM(state)->display, PLATFORM(state)->window, GLX_SWAP_INTERVAL_EXT, &interval);
+		if(xc->swap_caps & MKFW_SWAP_CAP_TEAR) {
+			x11_round_trips(state->context, 1);
+			xc->glXQueryDrawable(PLATFORM(state)->display, PLATFORM(state)->window, GLX_LATE_SWAPS_TEAR_EXT, &tear);
+		}
+		return tear ? -(int32_t)interval : (int32_t)interval;
+	}
+	if(xc->glXGetSwapIntervalMESA) {
+		return x11_swap_interval_mesa(state, 0, 0);
 	}
 	return 0;
 }
 
+// [=]===^=[ mkfw_window_get_swap_caps ]==========================================================[=]
+MKFW_API uint32_t mkfw_window_get_swap_caps(struct mkfw_window *state) {
+	if(!state || !PLATFORM(state)->glctx) {
+		return 0;
+	}
+	return CTX_PLATFORM(state->context)->swap_caps;
+}
+
+// [=]===^=[ mkfw_present_windows ]===============================================================[=]
+// Swap a set of GL windows together; windows == 0 means every window of
+// the context.  Only the last GL window in the set keeps its swap
+// interval, the others swap with interval 0, so the batch waits for one
+// vblank instead of one per window.  The set is expected to stay the
+// same from frame to frame: the intervals are only changed on the
+// drawables when a window moves in or out of the throttling slot.
+MKFW_API void mkfw_present_windows(struct mkfw_context *ctx, struct mkfw_window **windows, uint32_t count) {
+	if(!ctx) {
+		return;
+	}
+	X11_CHECK_THREAD(ctx);
+	if(!windows) {
+		windows = ctx->windows;
+		count = ctx->window_count;
+	}
+
+	uint32_t leader = count;
+	for(uint32_t i = count; i > 0; --i) {
+		if(windows[i - 1] && PLATFORM(windows[i - 1])->glctx) {
+			leader = i - 1;
+			break;
+		}
+	}
+	if(leader == count) {
+		return;
+	}
+
+	GLXContext current = glXGetCurrentContext ? glXGetCurrentContext() : 0;
+	for(uint32_t i = 0; i <= leader; ++i) {
+		struct mkfw_window *state = windows[i];
+		if(!state || !PLATFORM(state)->glctx) {
+			continue;
+		}
+		struct x11_mkfw_window *xw = PLATFORM(state);
+		if(!xw->swap_interval_known) {
+			xw->swap_interval = mkfw_window_get_swap_interval(state);
+			xw->swap_interval_applied = xw->swap_interval;
+			xw->swap_interval_known = 1;
+		}
+		int32_t interval = (i == leader) ? xw->swap_interval : 0;
+		if(xw->swap_interval_applied != interval) {
+			x11_swap_interval_apply(state, interval);
+		}
+		x11_window_swap(state, xw->glctx == current);
+	}
+}
+
 // [=]===^=[ mkfw_get_time ]=======================================================================[=]
 MKFW_API uint64_t mkfw_get_time(void) {
 	struct timespec ts;
@@ -2016,9 +3767,9 @@ MKFW_API void mkfw_window_set_icon(struct mkfw_window *state, int32_t width, int
 		uint32_t a = rgba[i * 4 + 3];
 		data[2 + i] = (a << 24) | (r << 16) | (g << 8) | b;
 	}
-	Atom net_wm_icon = XInternAtom(PLATFORM(state)->display, "_NET_WM_ICON", False);
+	Atom net_wm_icon = X11_ATOM(state, NET_WM_ICON);
 	XChangeProperty(PLATFORM(state)->display, PLATFORM(state)->window, net_wm_icon, XA_CARDINAL, 32, PropModeReplace, (unsigned char *)data, data_len);
-	XFlush(PLATFORM(state)->display);
+	x11_flush(state->context);
 	free(data);
 }
 
@@ -2033,12 +3784,14 @@ static int32_t mkfw_query_monitors_into(struct mkfw_context *ctx) {
 	int32_t max = MKFW_MAX_MONITORS;
 
 	Window root = DefaultRootWindow(dpy);
+	x11_round_trips(ctx, 1);
 	XRRScreenResources *sr = XRRGetScreenResourcesCurrent(dpy, root);
 	if(!sr) {
 		mkfw_error("monitor query: XRRGetScreenResourcesCurrent returned 0");
 		return 0;
 	}
 
+	x11_round_trips(ctx, 1);
 	RROutput primary_output = XRRGetOutputPrimary(dpy, root);
 
 	// Global work area from _NET_WORKAREA (first desktop); intersected per
@@ -2046,12 +3799,13 @@ static int32_t mkfw_query_monitors_into(struct mkfw_context *ctx) {
 	int32_t wa_x = 0, wa_y = 0, wa_w = 0, wa_h = 0;
 	uint8_t have_workarea = 0;
 	{
-		Atom net_workarea = XInternAtom(dpy, "_NET_WORKAREA", True);
+		Atom net_workarea = CTX_PLATFORM(ctx)->atoms[X11_ATOM_NET_WORKAREA];
 		if(net_workarea != None) {
 			Atom actual_type;
 			int actual_format;
 			unsigned long nitems = 0, bytes_after = 0;
 			unsigned char *data = 0;
+			x11_round_trips(ctx, 1);
 			if(XGetWindowProperty(dpy, root, net_workarea, 0, 4, False, XA_CARDINAL, &actual_type, &actual_format, &nitems, &bytes_after, &data) == Success) {
 				if(data && actual_format == 32 && nitems >= 4) {
 					long *v = (long *)(void *)data;
@@ -2070,6 +3824,7 @@ static int32_t mkfw_query_monitors_into(struct mkfw_context *ctx) {
 
 	int32_t count = 0;
 	for(int i = 0; i < sr->ncrtc && count < max; ++i) {
+		x11_round_trips(ctx, 1);
 		XRRCrtcInfo *ci = XRRGetCrtcInfo(dpy, sr, sr->crtcs[i]);
 		if(!ci || ci->mode == None || ci->noutput == 0) {
 			if(ci) {
@@ -2097,6 +3852,7 @@ static int32_t mkfw_query_monitors_into(struct mkfw_context *ctx) {
 		}
 
 		// Name and physical size from the output
+		x11_round_trips(ctx, 1);
 		XRROutputInfo *oi = XRRGetOutputInfo(dpy, sr, ci->outputs[0]);
 		if(oi) {
 			snprintf(m->name, sizeof(m->name), "%s", oi->name);
@@ -2183,12 +3939,14 @@ MKFW_API int32_t mkfw_get_video_modes(struct mkfw_context *ctx, int32_t monitor_
 	}
 	Display *dpy = CTX_PLATFORM(ctx)->display;
 	Window root = DefaultRootWindow(dpy);
+	x11_round_trips(ctx, 1);
 	XRRScreenResources *sr = XRRGetScreenResourcesCurrent(dpy, root);
 	if(!sr) {
 		return 0;
 	}
 
 	int32_t count = 0;
+	x11_round_trips(ctx, 1);
 	XRROutputInfo *oi = XRRGetOutputInfo(dpy, sr, CTX_PLATFORM(ctx)->monitor_output[monitor_index]);
 	if(oi) {
 		for(int i = 0; i < oi->nmode && count < max; ++i) {
@@ -2224,20 +3982,13 @@ MKFW_API int32_t mkfw_get_video_modes(struct mkfw_context *ctx, int32_t monitor_
 
 // [=]===^=[ mkfw_window_set_position ]===========================================================[=]
 MKFW_API void mkfw_window_set_position(struct mkfw_window *state, int32_t x, int32_t y) {
+	X11_CHECK_THREAD(state->context);
 	XMoveWindow(PLATFORM(state)->display, PLATFORM(state)->window, x, y);
 }
 
 // [=]===^=[ mkfw_window_get_position ]===========================================================[=]
 MKFW_API void mkfw_window_get_position(struct mkfw_window *state, int32_t *x, int32_t *y) {
-	Window child;
-	int32_t tx, ty;
-	XTranslateCoordinates(PLATFORM(state)->display, PLATFORM(state)->window, DefaultRootWindow(PLATFORM(state)->display), 0, 0, &tx, &ty, &child);
-	if(x) {
-		*x = tx;
-	}
-	if(y) {
-		*y = ty;
-	}
+	x11_window_position(state, x, y);
 }
 
 // [=]===^=[ mkfw_window_maximize ]===============================================================[=]
@@ -2246,14 +3997,14 @@ MKFW_API void mkfw_window_maximize(struct mkfw_window *state) {
 	XEvent ev = {0};
 	ev.xclient.type = ClientMessage;
 	ev.xclient.window = PLATFORM(state)->window;
-	ev.xclient.message_type = PLATFORM(state)->net_wm_state;
+	ev.xclient.message_type = X11_ATOM(state, NET_WM_STATE);
 	ev.xclient.format = 32;
 	ev.xclient.data.l[0] = 1; // _NET_WM_STATE_ADD
-	ev.xclient.data.l[1] = PLATFORM(state)->net_wm_state_maximized_horz;
-	ev.xclient.data.l[2] = PLATFORM(state)->net_wm_state_maximized_vert;
+	ev.xclient.data.l[1] = X11_ATOM(state, NET_WM_STATE_MAXIMIZED_HORZ);
+	ev.xclient.data.l[2] = X11_ATOM(state, NET_WM_STATE_MAXIMIZED_VERT);
 	ev.xclient.data.l[3] = 1; // source: application
 	XSendEvent(dpy, DefaultRootWindow(dpy), False, SubstructureRedirectMask | SubstructureNotifyMask, &ev);
-	XFlush(dpy);
+	x11_flush(state->context);
 }
 
 // [=]===^=[ mkfw_window_minimize ]===============================================================[=]
@@ -2267,15 +4018,15 @@ MKFW_API void mkfw_window_restore(struct mkfw_window *state) {
 	XEvent ev = {0};
 	ev.xclient.type = ClientMessage;
 	ev.xclient.window = PLATFORM(state)->window;
-	ev.xclient.message_type = PLATFORM(state)->net_wm_state;
+	ev.xclient.message_type = X11_ATOM(state, NET_WM_STATE);
 	ev.xclient.format = 32;
 	ev.xclient.data.l[0] = 0; // _NET_WM_STATE_REMOVE
-	ev.xclient.data.l[1] = PLATFORM(state)->net_wm_state_maximized_horz;
-	ev.xclient.data.l[2] = PLATFORM(state)->net_wm_state_maximized_vert;
+	ev.xclient.data.l[1] = X11_ATOM(state, NET_WM_STATE_MAXIMIZED_HORZ);
+	ev.xclient.data.l[2] = X11_ATOM(state, NET_WM_STATE_MAXIMIZED_VERT);
 	ev.xclient.data.l[3] = 1;
 	XSendEvent(dpy, DefaultRootWindow(dpy), False, SubstructureRedirectMask | SubstructureNotifyMask, &ev);
 	XMapWindow(dpy, PLATFORM(state)->window);
-	XFlush(dpy);
+	x11_flush(state->context);
 }
 
 // [=]===^=[ mkfw_window_get_content_scale ]=============================================================[=]
@@ -2289,14 +4040,14 @@ MKFW_API void mkfw_window_request_attention(struct mkfw_window *state) {
 	XEvent ev = {0};
 	ev.xclient.type = ClientMessage;
 	ev.xclient.window = PLATFORM(state)->window;
-	ev.xclient.message_type = PLATFORM(state)->net_wm_state;
+	ev.xclient.message_type = X11_ATOM(state, NET_WM_STATE);
 	ev.xclient.format = 32;
 	ev.xclient.data.l[0] = 1; // _NET_WM_STATE_ADD
-	ev.xclient.data.l[1] = PLATFORM(state)->net_wm_state_demands_attention;
+	ev.xclient.data.l[1] = X11_ATOM(state, NET_WM_STATE_DEMANDS_ATTENTION);
 	ev.xclient.data.l[2] = 0;
 	ev.xclient.data.l[3] = 1; // source: application
 	XSendEvent(dpy, DefaultRootWindow(dpy), False, SubstructureRedirectMask | SubstructureNotifyMask, &ev);
-	XFlush(dpy);
+	x11_flush(state->context);
 }
 
 // [=]===^=[ mkfw_window_focus ]=================================================================[=]
@@ -2311,12 +4062,12 @@ MKFW_API void mkfw_window_focus(struct mkfw_window *state) {
 	XEvent ev = {0};
 	ev.xclient.type = ClientMessage;
 	ev.xclient.window = win;
-	ev.xclient.message_type = XInternAtom(dpy, "_NET_ACTIVE_WINDOW", False);
+	ev.xclient.message_type = X11_ATOM(state, NET_ACTIVE_WINDOW);
 	ev.xclient.format = 32;
 	ev.xclient.data.l[0] = 1; // source: application
 	ev.xclient.data.l[1] = CurrentTime;
 	XSendEvent(dpy, DefaultRootWindow(dpy), False, SubstructureRedirectMask | SubstructureNotifyMask, &ev);
-	XFlush(dpy);
+	x11_flush(state->context);
 }
 
 // [=]===^=[ mkfw_wait_events ]==================================================================[=]
@@ -2324,6 +4075,7 @@ MKFW_API void mkfw_wait_events(struct mkfw_context *ctx) {
 	if(!ctx || !CTX_PLATFORM(ctx)->display) {
 		return;
 	}
+	X11_CHECK_THREAD(ctx);
 	Display *dpy = CTX_PLATFORM(ctx)->display;
 	if(!XPending(dpy)) {
 		struct pollfd pfd;
@@ -2339,6 +4091,7 @@ MKFW_API void mkfw_wait_events_timeout(struct mkfw_context *ctx, uint64_t nanose
 	if(!ctx || !CTX_PLATFORM(ctx)->display) {
 		return;
 	}
+	X11_CHECK_THREAD(ctx);
 	Display *dpy = CTX_PLATFORM(ctx)->display;
 	if(!XPending(dpy)) {
 		struct pollfd pfd;
@@ -2349,30 +4102,105 @@ MKFW_API void mkfw_wait_events_timeout(struct mkfw_context *ctx, uint64_t nanose
 	mkfw_poll_events(ctx);
 }
 
+// [=]===^=[ x11_window_recycle ]=================================================================[=]
+// Hide the window and put it back in the pool with its input state,
+// callbacks and everything the setters change on the X window reset, as
+// if freshly created.
+static void x11_window_recycle(struct mkfw_window *state) {
+	struct mkfw_context *ctx = state->context;
+	struct x11_mkfw_window *xw = PLATFORM(state);
+
+	XUnmapWindow(xw->display, xw->window);
+	x11_window_initial_wm_state(state, xw->options.flags);
+	xw->min_width = 0;
+	xw->min_height = 0;
+	xw->max_width = 0;
+	xw->max_height = 0;
+	xw->aspect_num = 0;
+	xw->aspect_den = 0;
+	xw->aspect_ratio = 0.0f;
+	x11_apply_size_hints(state);
+	XDeleteProperty(xw->display, xw->window, X11_ATOM(state, MOTIF_WM_HINTS));
+	XDeleteProperty(xw->display, xw->window, X11_ATOM(state, NET_WM_WINDOW_OPACITY));
+	XDeleteProperty(xw->display, xw->window, X11_ATOM(state, NET_WM_ICON));
+	XMoveWindow(xw->display, xw->window, 0, 0);
+
+	// Back to the GLX default interval; the counters restart from zero.
+	if(xw->swap_interval_known) {
+		x11_swap_interval_apply(state, 1);
+		xw->swap_interval_known = 0;
+	}
+	xw->swaps_base = xw->present.swaps;
+	xw->present.ust_ns = 0;
+	xw->present.submit_ns = 0;
+	xw->present.refresh_ns = 0;
+	xw->present.missed_vblanks = 0;
+
+	if(xw->cursor_locked) {
+		XUngrabPointer(xw->display, CurrentTime);
+	}
+	if(xw->xic && state->has_focus) {
+		XUnsetICFocus(xw->xic);
+	}
+	XUndefineCursor(xw->display, xw->window);
+	XDeleteProperty(xw->display, xw->window, X11_ATOM(state, XDND_AWARE));
+	free(xw->clipboard_text);
+
+	mkfw_context_unlink_window(ctx, state);
+	if(CTX_PLATFORM(ctx)->pointer_window == state) {
+		CTX_PLATFORM(ctx)->pointer_window = 0;
+	}
+
+	memset(state, 0, sizeof(*state));
+	state->context = ctx;
+	state->platform = xw;
+
+	xw->cursor_locked = 0;
+	xw->cursor_visible = 1;
+	xw->current_cursor = 0;
+	xw->active_custom_cursor = 0;
+	xw->clipboard_text = 0;
+	xw->warp_pending = 0;
+	xw->should_close = 0;
+	xw->in_window = 0;
+	xw->delta_polled = 0;
+	xw->modifiers = 0;
+	xw->key_modifier_bits = 0;
+	memset(xw->keys_down, 0, sizeof(xw->keys_down));
+	xw->last_mouse_dx = 0.0;
+	xw->last_mouse_dy = 0.0;
+	xw->accumulated_dx = 0.0;
+	xw->accumulated_dy = 0.0;
+	xw->mouse_sensitivity = 1.0;
+	memset(&xw->coalesced_delta, 0, sizeof(xw->coalesced_delta));
+	xw->xdnd_source = 0;
+	xw->xdnd_has_uri_list = 0;
+	xw->options.flags &= ~MKFW_WIN_RECYCLE;
+
+	mkfw_window_update_event_mask(state);
+	ctx->pool[ctx->pool_count++] = state;
+	x11_flush(ctx);
+}
+
 // [=]===^=[ mkfw_window_destroy ]================================================================[=]
 MKFW_API void mkfw_window_destroy(struct mkfw_window *state) {
 	if(!state) {
 		return;
 	}
+	X11_CHECK_THREAD(state->context);
+
+	struct mkfw_context *ctx = state->context;
+	if(ctx && (PLATFORM(state)->options.flags & MKFW_WIN_RECYCLE) && !state->is_fullscreen && ctx->pool_count < MKFW_MAX_POOLED_WINDOWS) {
+		x11_window_recycle(state);
+		return;
+	}
 
 	if(PLATFORM(state)->cursor_locked) {
 		XUngrabPointer(PLATFORM(state)->display, CurrentTime);
 	}
-	if(PLATFORM(state)->hidden_cursor) {
-		XFreeCursor(PLATFORM(state)->display, PLATFORM(state)->hidden_cursor);
-	}
-
 	if(PLATFORM(state)->xic) {
 		XDestroyIC(PLATFORM(state)->xic);
 	}
-	if(PLATFORM(state)->xim) {
-		XCloseIM(PLATFORM(state)->xim);
-	}
-	for(uint32_t i = 0; i < MKFW_CURSOR_LAST; ++i) {
-		if(PLATFORM(state)->cursors[i]) {
-			XFreeCursor(PLATFORM(state)->display, PLATFORM(state)->cursors[i]);
-		}
-	}
 	free(PLATFORM(state)->clipboard_text);
 
 	if(PLATFORM(state)->glctx) {
@@ -2382,17 +4210,16 @@ MKFW_API void mkfw_window_destroy(struct mkfw_window *state) {
 	XDestroyWindow(PLATFORM(state)->display, PLATFORM(state)->window);
 
 	// Unlink from its context's window list
-	struct mkfw_context *ctx = state->context;
 	if(ctx) {
-		for(uint32_t i = 0; i < ctx->window_count; ++i) {
-			if(ctx->windows[i] == state) {
-				for(uint32_t j = i + 1; j < ctx->window_count; ++j) {
-					ctx->windows[j - 1] = ctx->windows[j];
-				}
-				ctx->windows[ctx->window_count - 1] = 0;
-				--ctx->window_count;
-				break;
-			}
+		x11_window_map_remove(ctx, PLATFORM(state)->window);
+		if(CTX_PLATFORM(ctx)->pointer_window == state) {
+			CTX_PLATFORM(ctx)->pointer_window = 0;
+		}
+		mkfw_context_unlink_window(ctx, state);
+		// Only a window that wanted raw motion can change the answer, and
+		// skipping the rescan keeps teardown O(1) with many windows.
+		if(x11_window_wants_raw_motion(state)) {
+			x11_update_raw_motion(ctx);
 		}
 	}
 
@@ -2400,6 +4227,19 @@ MKFW_API void mkfw_window_destroy(struct mkfw_window *state) {
 	free(state);
 }
 
+// [=]===^=[ mkfw_window_pool_clear ]=============================================================[=]
+MKFW_API void mkfw_window_pool_clear(struct mkfw_context *ctx) {
+	if(!ctx) {
+		return;
+	}
+	while(ctx->pool_count > 0) {
+		struct mkfw_window *state = ctx->pool[--ctx->pool_count];
+		ctx->pool[ctx->pool_count] = 0;
+		PLATFORM(state)->options.flags &= ~MKFW_WIN_RECYCLE;
+		mkfw_window_destroy(state);
+	}
+}
+
 // [=]===^=[ mkfw_shutdown ]======================================================================[=]
 MKFW_API void mkfw_shutdown(struct mkfw_context *ctx) {
 	if(!ctx) {
@@ -2410,10 +4250,40 @@ MKFW_API void mkfw_shutdown(struct mkfw_context *ctx) {
 	while(ctx->window_count > 0) {
 		mkfw_window_destroy(ctx->windows[ctx->window_count - 1]);
 	}
+	mkfw_window_pool_clear(ctx);
+
+	x11_input_thread_stop(ctx);
+	x11_loader_reap(ctx, 1);
+	if(CTX_PLATFORM(ctx)->probe_running) {
+		pthread_join(CTX_PLATFORM(ctx)->probe_thread, 0);
+	}
+
+	// Requests never created finish without a window or callback.
+	struct mkfw_window_request *req;
+	while((req = mkfw_window_request_pop(ctx))) {
+		req->ready = 1;
+	}
 
-	if(CTX_PLATFORM(ctx)->display) {
-		XCloseDisplay(CTX_PLATFORM(ctx)->display);
+	struct x11_mkfw_context *xc = CTX_PLATFORM(ctx);
+	if(xc->display) {
+		for(uint32_t i = 0; i < MKFW_CURSOR_LAST; ++i) {
+			if(xc->cursors[i]) {
+				XFreeCursor(xc->display, xc->cursors[i]);
+			}
+		}
+		if(xc->hidden_cursor) {
+			XFreeCursor(xc->display, xc->hidden_cursor);
+		}
+		if(xc->xim) {
+			XCloseIM(xc->xim);
+		}
+		XCloseDisplay(xc->display);
 	}
+	free(CTX_PLATFORM(ctx)->gl_version_cache);
+	free(CTX_PLATFORM(ctx)->fbconfigs);
+	free(CTX_PLATFORM(ctx)->window_map);
+	free(ctx->event_queue.events);
+	free(ctx->windows);
 	free(ctx->platform);
 	free(ctx);
 }
@@ -2433,6 +4303,10 @@ MKFW_API void mkfw_window_set_mouse_sensitivity(struct mkfw_window *state, doubl
 
 // [=]===^=[ mkfw_window_get_and_clear_mouse_delta ]=====================================================[=]
 MKFW_API void mkfw_window_get_and_clear_mouse_delta(struct mkfw_window *state, int32_t *dx, int32_t *dy) {
+	if(!PLATFORM(state)->delta_polled) {
+		PLATFORM(state)->delta_polled = 1;
+		mkfw_window_update_event_mask(state);
+	}
 	int32_t tdx = (int32_t)PLATFORM(state)->accumulated_dx;
 	int32_t tdy = (int32_t)PLATFORM(state)->accumulated_dy;
 	PLATFORM(state)->accumulated_dx -= (double)tdx;
@@ -2453,13 +4327,14 @@ MKFW_API void mkfw_window_set_cursor_shape(struct mkfw_window *state, uint32_t c
 	PLATFORM(state)->current_cursor = cursor;
 	PLATFORM(state)->active_custom_cursor = 0;
 	if(PLATFORM(state)->cursor_visible) {
-		XDefineCursor(PLATFORM(state)->display, PLATFORM(state)->window, PLATFORM(state)->cursors[cursor]);
-		XFlush(PLATFORM(state)->display);
+		XDefineCursor(PLATFORM(state)->display, PLATFORM(state)->window, x11_shape_cursor(state->context, cursor));
+		x11_flush(state->context);
 	}
 }
 
 // [=]===^=[ mkfw_cursor_create_rgba ]============================================================[=]
 MKFW_API struct mkfw_cursor *mkfw_cursor_create_rgba(struct mkfw_context *ctx, uint32_t width, uint32_t height, uint8_t *rgba, int32_t hotspot_x, int32_t hotspot_y) {
+	x11_need_xcursor();
 	if(!mkfw_XcursorImageCreate) {
 		mkfw_error("libXcursor not loaded; custom cursors unavailable");
 		return 0;
@@ -2512,28 +4387,28 @@ MKFW_API void mkfw_window_set_custom_cursor(struct mkfw_window *state, struct mk
 	PLATFORM(state)->active_custom_cursor = cursor ? cursor->x_cursor : 0;
 	if(PLATFORM(state)->cursor_visible) {
 		XDefineCursor(PLATFORM(state)->display, PLATFORM(state)->window, x11_active_cursor(state));
-		XFlush(PLATFORM(state)->display);
+		x11_flush(state->context);
 	}
 }
 
 // [=]===^=[ mkfw_window_get_cursor_position ]===========================================================[=]
+// Last pointer position reported by motion, crossing and button events;
+// once the pointer has left the window this is where it crossed out.
 MKFW_API void mkfw_window_get_cursor_position(struct mkfw_window *state, int32_t *x, int32_t *y) {
-	Window root_ret, child_ret;
-	int root_x, root_y, win_x, win_y;
-	unsigned int mask;
-	XQueryPointer(PLATFORM(state)->display, PLATFORM(state)->window, &root_ret, &child_ret, &root_x, &root_y, &win_x, &win_y, &mask);
 	if(x) {
-		*x = win_x;
+		*x = state->mouse_x;
 	}
 	if(y) {
-		*y = win_y;
+		*y = state->mouse_y;
 	}
 }
 
 // [=]===^=[ mkfw_window_set_cursor_position ]===========================================================[=]
 MKFW_API void mkfw_window_set_cursor_position(struct mkfw_window *state, int32_t x, int32_t y) {
 	XWarpPointer(PLATFORM(state)->display, None, PLATFORM(state)->window, 0, 0, 0, 0, x, y);
-	XFlush(PLATFORM(state)->display);
+	x11_flush(state->context);
+	state->mouse_x = x;
+	state->mouse_y = y;
 }
 
 // [=]===^=[ mkfw_window_set_clipboard_text ]===========================================================[=]
@@ -2545,15 +4420,16 @@ MKFW_API void mkfw_window_set_clipboard_text(struct mkfw_window *state, const ch
 		PLATFORM(state)->clipboard_text = (char *)malloc(len + 1);
 		memcpy(PLATFORM(state)->clipboard_text, text, len + 1);
 	}
-	XSetSelectionOwner(PLATFORM(state)->display, PLATFORM(state)->clipboard_atom, PLATFORM(state)->window, CurrentTime);
-	XFlush(PLATFORM(state)->display);
+	XSetSelectionOwner(PLATFORM(state)->display, X11_ATOM(state, CLIPBOARD), PLATFORM(state)->window, CurrentTime);
+	x11_flush(state->context);
 }
 
 // [=]===^=[ mkfw_window_get_clipboard_text ]===========================================================[=]
 // Returns a malloc'd UTF-8 string the caller must release with free(),
 // or 0 if the clipboard is empty / unavailable.
 MKFW_API char *mkfw_window_get_clipboard_text(struct mkfw_window *state) {
-	Window owner = XGetSelectionOwner(PLATFORM(state)->display, PLATFORM(state)->clipboard_atom);
+	x11_round_trips(state->context, 1);
+	Window owner = XGetSelectionOwner(PLATFORM(state)->display, X11_ATOM(state, CLIPBOARD));
 	if(owner == None) {
 		return 0;
 	}
@@ -2568,7 +4444,7 @@ MKFW_API char *mkfw_window_get_clipboard_text(struct mkfw_window *state) {
 		return copy;
 	}
 
-	XConvertSelection(PLATFORM(state)->display, PLATFORM(state)->clipboard_atom, PLATFORM(state)->utf8_string_atom, PLATFORM(state)->mkfw_clipboard_atom, PLATFORM(state)->window, CurrentTime);
+	XConvertSelection(PLATFORM(state)->display, X11_ATOM(state, CLIPBOARD), X11_ATOM(state, UTF8_STRING), X11_ATOM(state, MKFW_CLIPBOARD), PLATFORM(state)->window, CurrentTime);
 	XFlush(PLATFORM(state)->display);
 
 	XEvent ev;
@@ -2583,7 +4459,8 @@ MKFW_API char *mkfw_window_get_clipboard_text(struct mkfw_window *state) {
 			unsigned long nitems, bytes_after;
 			unsigned char *data = 0;
 
-			XGetWindowProperty(PLATFORM(state)->display, PLATFORM(state)->window, PLATFORM(state)->mkfw_clipboard_atom, 0, 1024 * 1024, True, AnyPropertyType, &actual_type, &actual_format, &nitems, &bytes_after, &data);
+			x11_round_trips(state->context, 1);
+			XGetWindowProperty(PLATFORM(state)->display, PLATFORM(state)->window, X11_ATOM(state, MKFW_CLIPBOARD), 0, 1024 * 1024, True, AnyPropertyType, &actual_type, &actual_format, &nitems, &bytes_after, &data);
 
 			if(data) {
 				size_t len = nitems * (actual_format / 8);
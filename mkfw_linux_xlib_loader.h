@@ -22,6 +22,8 @@ typedef int (*PFN_XDefineCursor)(Display *, Window, Cursor);
 typedef int (*PFN_XDeleteProperty)(Display *, Window, Atom);
 typedef void (*PFN_XDestroyIC)(XIC);
 typedef int (*PFN_XDestroyWindow)(Display *, Window);
+typedef int (*PFN_XDisplayKeycodes)(Display *, int *, int *);
+typedef int (*PFN_XEventsQueued)(Display *, int);
 typedef int (*PFN_XFlush)(Display *);
 typedef int (*PFN_XFree)(void *);
 typedef int (*PFN_XFreeColormap)(Display *, Colormap);
@@ -30,6 +32,8 @@ typedef void (*PFN_XFreeEventData)(Display *, XGenericEventCookie *);
 typedef int (*PFN_XFreePixmap)(Display *, Pixmap);
 typedef Bool (*PFN_XGetEventData)(Display *, XGenericEventCookie *);
 typedef Status (*PFN_XGetGeometry)(Display *, Drawable, Window *, int *, int *, unsigned int *, unsigned int *, unsigned int *, unsigned int *);
+typedef KeySym *(*PFN_XGetKeyboardMapping)(Display *, KeyCode, int, int *);
+typedef int (*PFN_XGetPointerMapping)(Display *, unsigned char *, int);
 typedef Window (*PFN_XGetSelectionOwner)(Display *, Atom);
 typedef Status (*PFN_XGetWindowAttributes)(Display *, Window, XWindowAttributes *);
 typedef int (*PFN_XGetWindowProperty)(Display *, Window, Atom, long, long, Bool, Atom, Atom *, int *, unsigned long *, unsigned long *, unsigned char **);
@@ -37,6 +41,7 @@ typedef int (*PFN_XGrabPointer)(Display *, Window, Bool, unsigned int, int, int,
 typedef Status (*PFN_XIconifyWindow)(Display *, Window, int);
 typedef Status (*PFN_XInitThreads)(void);
 typedef Atom (*PFN_XInternAtom)(Display *, const char *, Bool);
+typedef Status (*PFN_XInternAtoms)(Display *, char **, int, Bool, Atom *);
 typedef KeySym (*PFN_XLookupKeysym)(XKeyEvent *, int);
 typedef int (*PFN_XLookupString)(XKeyEvent *, char *, int, KeySym *, XComposeStatus *);
 typedef int (*PFN_XMapWindow)(Display *, Window);
@@ -45,12 +50,15 @@ typedef int (*PFN_XMoveWindow)(Display *, Window, int, int);
 typedef int (*PFN_XNextEvent)(Display *, XEvent *);
 typedef Display *(*PFN_XOpenDisplay)(const char *);
 typedef XIM (*PFN_XOpenIM)(Display *, XrmDatabase, char *, char *);
+typedef int (*PFN_XPeekEvent)(Display *, XEvent *);
 typedef int (*PFN_XPending)(Display *);
 typedef int (*PFN_XRaiseWindow)(Display *, Window);
 typedef Bool (*PFN_XQueryExtension)(Display *, const char *, int *, int *, int *);
 typedef Bool (*PFN_XQueryPointer)(Display *, Window, Window *, Window *, int *, int *, int *, int *, unsigned int *);
+typedef int (*PFN_XRefreshKeyboardMapping)(XMappingEvent *);
 typedef int (*PFN_XResizeWindow)(Display *, Window, unsigned int, unsigned int);
 typedef char *(*PFN_XResourceManagerString)(Display *);
+typedef int (*PFN_XSelectInput)(Display *, Window, long);
 typedef Status (*PFN_XSendEvent)(Display *, Window, Bool, long, XEvent *);
 typedef int (*PFN_XSetClassHint)(Display *, Window, XClassHint *);
 typedef void (*PFN_XSetICFocus)(XIC);
@@ -65,6 +73,8 @@ typedef int (*PFN_XUngrabPointer)(Display *, Time);
 typedef int (*PFN_XUnmapWindow)(Display *, Window);
 typedef void (*PFN_XUnsetICFocus)(XIC);
 typedef int (*PFN_XWarpPointer)(Display *, Window, Window, int, int, unsigned int, unsigned int, int, int);
+typedef int (*PFN_XWindowEvent)(Display *, Window, long, XEvent *);
+typedef Bool (*PFN_XkbSetDetectableAutoRepeat)(Display *, Bool, Bool *);
 typedef void (*PFN_XrmInitialize)(void);
 typedef XrmDatabase (*PFN_XrmGetStringDatabase)(const char *);
 typedef Bool (*PFN_XrmGetResource)(XrmDatabase, const char *, const char *, char **, XrmValue *);
@@ -88,6 +98,8 @@ static PFN_XDefineCursor mkfw_XDefineCursor;
 static PFN_XDeleteProperty mkfw_XDeleteProperty;
 static PFN_XDestroyIC mkfw_XDestroyIC;
 static PFN_XDestroyWindow mkfw_XDestroyWindow;
+static PFN_XDisplayKeycodes mkfw_XDisplayKeycodes;
+static PFN_XEventsQueued mkfw_XEventsQueued;
 static PFN_XFlush mkfw_XFlush;
 static PFN_XFree mkfw_XFree;
 static PFN_XFreeColormap mkfw_XFreeColormap;
@@ -96,6 +108,8 @@ static PFN_XFreeEventData mkfw_XFreeEventData;
 static PFN_XFreePixmap mkfw_XFreePixmap;
 static PFN_XGetEventData mkfw_XGetEventData;
 static PFN_XGetGeometry mkfw_XGetGeometry;
+static PFN_XGetKeyboardMapping mkfw_XGetKeyboardMapping;
+static PFN_XGetPointerMapping mkfw_XGetPointerMapping;
 static PFN_XGetSelectionOwner mkfw_XGetSelectionOwner;
 static PFN_XGetWindowAttributes mkfw_XGetWindowAttributes;
 static PFN_XGetWindowProperty mkfw_XGetWindowProperty;
@@ -103,6 +117,7 @@ static PFN_XGrabPointer mkfw_XGrabPointer;
 static PFN_XIconifyWindow mkfw_XIconifyWindow;
 static PFN_XInitThreads mkfw_XInitThreads;
 static PFN_XInternAtom mkfw_XInternAtom;
+static PFN_XInternAtoms mkfw_XInternAtoms;
 static PFN_XLookupKeysym mkfw_XLookupKeysym;
 static PFN_XLookupString mkfw_XLookupString;
 static PFN_XMapWindow mkfw_XMapWindow;
@@ -111,12 +126,15 @@ static PFN_XMoveWindow mkfw_XMoveWindow;
 static PFN_XNextEvent mkfw_XNextEvent;
 static PFN_XOpenDisplay mkfw_XOpenDisplay;
 static PFN_XOpenIM mkfw_XOpenIM;
+static PFN_XPeekEvent mkfw_XPeekEvent;
 static PFN_XPending mkfw_XPending;
 static PFN_XRaiseWindow mkfw_XRaiseWindow;
 static PFN_XQueryExtension mkfw_XQueryExtension;
 static PFN_XQueryPointer mkfw_XQueryPointer;
+static PFN_XRefreshKeyboardMapping mkfw_XRefreshKeyboardMapping;
 static PFN_XResizeWindow mkfw_XResizeWindow;
 static PFN_XResourceManagerString mkfw_XResourceManagerString;
+static PFN_XSelectInput mkfw_XSelectInput;
 static PFN_XSendEvent mkfw_XSendEvent;
 static PFN_XSetClassHint mkfw_XSetClassHint;
 static PFN_XSetICFocus mkfw_XSetICFocus;
@@ -131,6 +149,8 @@ static PFN_XUngrabPointer mkfw_XUngrabPointer;
 static PFN_XUnmapWindow mkfw_XUnmapWindow;
 static PFN_XUnsetICFocus mkfw_XUnsetICFocus;
 static PFN_XWarpPointer mkfw_XWarpPointer;
+static PFN_XWindowEvent mkfw_XWindowEvent;
+static PFN_XkbSetDetectableAutoRepeat mkfw_XkbSetDetectableAutoRepeat;
 static PFN_XrmInitialize mkfw_XrmInitialize;
 static PFN_XrmGetStringDatabase mkfw_XrmGetStringDatabase;
 static PFN_XrmGetResource mkfw_XrmGetResource;
@@ -154,6 +174,8 @@ static PFN_Xutf8LookupString mkfw_Xutf8LookupString;
 #define XDeleteProperty mkfw_XDeleteProperty
 #define XDestroyIC mkfw_XDestroyIC
 #define XDestroyWindow mkfw_XDestroyWindow
+#define XDisplayKeycodes mkfw_XDisplayKeycodes
+#define XEventsQueued mkfw_XEventsQueued
 #define XFlush mkfw_XFlush
 #define XFree mkfw_XFree
 #define XFreeColormap mkfw_XFreeColormap
@@ -162,6 +184,8 @@ static PFN_Xutf8LookupString mkfw_Xutf8LookupString;
 #define XFreePixmap mkfw_XFreePixmap
 #define XGetEventData mkfw_XGetEventData
 #define XGetGeometry mkfw_XGetGeometry
+#define XGetKeyboardMapping mkfw_XGetKeyboardMapping
+#define XGetPointerMapping mkfw_XGetPointerMapping
 #define XGetSelectionOwner mkfw_XGetSelectionOwner
 #define XGetWindowAttributes mkfw_XGetWindowAttributes
 #define XGetWindowProperty mkfw_XGetWindowProperty
@@ -169,6 +193,7 @@ static PFN_Xutf8LookupString mkfw_Xutf8LookupString;
 #define XIconifyWindow mkfw_XIconifyWindow
 #define XInitThreads mkfw_XInitThreads
 #define XInternAtom mkfw_XInternAtom
+#define XInternAtoms mkfw_XInternAtoms
 #define XLookupKeysym mkfw_XLookupKeysym
 #define XLookupString mkfw_XLookupString
 #define XMapWindow mkfw_XMapWindow
@@ -177,12 +202,15 @@ static PFN_Xutf8LookupString mkfw_Xutf8LookupString;
 #define XNextEvent mkfw_XNextEvent
 #define XOpenDisplay mkfw_XOpenDisplay
 #define XOpenIM mkfw_XOpenIM
+#define XPeekEvent mkfw_XPeekEvent
 #define XPending mkfw_XPending
 #define XRaiseWindow mkfw_XRaiseWindow
 #define XQueryExtension mkfw_XQueryExtension
 #define XQueryPointer mkfw_XQueryPointer
+#define XRefreshKeyboardMapping mkfw_XRefreshKeyboardMapping
 #define XResizeWindow mkfw_XResizeWindow
 #define XResourceManagerString mkfw_XResourceManagerString
+#define XSelectInput mkfw_XSelectInput
 #define XSendEvent mkfw_XSendEvent
 #define XSetClassHint mkfw_XSetClassHint
 #define XSetICFocus mkfw_XSetICFocus
@@ -197,6 +225,8 @@ static PFN_Xutf8LookupString mkfw_Xutf8LookupString;
 #define XUnmapWindow mkfw_XUnmapWindow
 #define XUnsetICFocus mkfw_XUnsetICFocus
 #define XWarpPointer mkfw_XWarpPointer
+#define XWindowEvent mkfw_XWindowEvent
+#define XkbSetDetectableAutoRepeat mkfw_XkbSetDetectableAutoRepeat
 #define XrmInitialize mkfw_XrmInitialize
 #define XrmGetStringDatabase mkfw_XrmGetStringDatabase
 #define XrmGetResource mkfw_XrmGetResource
@@ -234,6 +264,8 @@ static void load_x11_functions(void) {
 	LOAD(XDeleteProperty);
 	LOAD(XDestroyIC);
 	LOAD(XDestroyWindow);
+	LOAD(XDisplayKeycodes);
+	LOAD(XEventsQueued);
 	LOAD(XFlush);
 	LOAD(XFree);
 	LOAD(XFreeColormap);
@@ -242,6 +274,8 @@ static void load_x11_functions(void) {
 	LOAD(XFreePixmap);
 	LOAD(XGetEventData);
 	LOAD(XGetGeometry);
+	LOAD(XGetKeyboardMapping);
+	LOAD(XGetPointerMapping);
 	LOAD(XGetSelectionOwner);
 	LOAD(XGetWindowAttributes);
 	LOAD(XGetWindowProperty);
@@ -249,6 +283,7 @@ static void load_x11_functions(void) {
 	LOAD(XIconifyWindow);
 	LOAD(XInitThreads);
 	LOAD(XInternAtom);
+	LOAD(XInternAtoms);
 	LOAD(XLookupKeysym);
 	LOAD(XLookupString);
 	LOAD(XMapWindow);
@@ -257,12 +292,15 @@ static void load_x11_functions(void) {
 	LOAD(XNextEvent);
 	LOAD(XOpenDisplay);
 	LOAD(XOpenIM);
+	LOAD(XPeekEvent);
 	LOAD(XPending);
 	LOAD(XRaiseWindow);
 	LOAD(XQueryExtension);
 	LOAD(XQueryPointer);
+	LOAD(XRefreshKeyboardMapping);
 	LOAD(XResizeWindow);
 	LOAD(XResourceManagerString);
+	LOAD(XSelectInput);
 	LOAD(XSendEvent);
 	LOAD(XSetClassHint);
 	LOAD(XSetICFocus);
@@ -277,6 +315,8 @@ static void load_x11_functions(void) {
 	LOAD(XUnmapWindow);
 	LOAD(XUnsetICFocus);
 	LOAD(XWarpPointer);
+	LOAD(XWindowEvent);
+	LOAD(XkbSetDetectableAutoRepeat);
 	LOAD(XrmInitialize);
 	LOAD(XrmGetStringDatabase);
 	LOAD(XrmGetResource);
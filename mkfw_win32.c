@@ -12,6 +12,8 @@
 #include <shellapi.h>
 #include <stdlib.h>
 
+#include "mkfw_internal.h"
+
 __declspec(dllexport) unsigned long NvOptimusEnablement = 0x00000001;
 __declspec(dllexport) int AmdPowerXpressRequestHighPerformance = 1;
 
@@ -146,6 +148,26 @@ static uint8_t mkfw_win32_class_registered;
 
 struct win32_mkfw_context {
 	HINSTANCE hinstance;
+
+	// Driver's maximum GL version for gl_major == 0 windows, probed at most
+	// once per context (win32_context_gl_version).
+	int32_t gl_max_major;
+	int32_t gl_max_minor;
+	uint8_t gl_probed;
+
+	// WGL_EXT_swap_control (+ _tear), resolved on the first GL window
+	// (win32_swap_resolve).  Both calls act on the current context.
+	uint8_t swap_resolved;
+	uint32_t swap_caps;   // MKFW_SWAP_CAP_*
+	BOOL (WINAPI *wglSwapIntervalEXT)(int);
+	int (WINAPI *wglGetSwapIntervalEXT)(void);
+
+	// ARB_sync entry points for frames_in_flight, resolved on the first
+	// fenced swap while a context is current (win32_fences_resolve).
+	uint8_t fences_resolved;
+	void *(WINAPI *glFenceSync)(unsigned int, unsigned int);
+	unsigned int (WINAPI *glClientWaitSync)(void *, unsigned int, uint64_t);
+	void (WINAPI *glDeleteSync)(void *);
 };
 
 // Win32 per-window platform state
@@ -169,6 +191,14 @@ struct win32_mkfw_window {
 	double accumulated_dx;
 	double accumulated_dy;
 	double mouse_sensitivity;
+	struct mkfw_delta_accumulator coalesced_delta;   // MKFW_INIT_COALESCE_MOTION
+	struct mkfw_present_stats present;               // CPU-timed swaps
+	void *fences[MKFW_MAX_FRAMES_IN_FLIGHT];         // frames_in_flight; see mkfw_window_swap_buffers
+	uint32_t fence_head;
+	uint8_t has_sync;                                // the window's context has GL 3.2 or ARB_sync
+	int32_t swap_interval;                           // as asked for; see mkfw_present_windows
+	int32_t swap_interval_applied;
+	uint8_t swap_interval_known;
 	int32_t min_width;
 	int32_t min_height;
 	int32_t max_width;
@@ -193,6 +223,10 @@ struct win32_mkfw_window {
 	// Window state callback tracking
 	uint8_t last_maximized;
 	uint8_t last_minimized;
+
+	// Options the window was last handed out with (title cleared);
+	// matched against new requests when it sits in the pool.
+	struct mkfw_window_options options;
 };
 
 // USB HID Usage Page 7 scancode for each PS/2 set-1 scancode that is *not*
@@ -386,9 +420,12 @@ static uint32_t map_vk_to_scancode(struct mkfw_window *state, WPARAM wParam, LPA
 		state->keyboard_state[keycode] = key_down;
 	}
 
-	// Call the key callback
-	if(keycode && state->key_callback) {
-		state->key_callback(state, keycode, key_down ? MKFW_PRESSED : MKFW_RELEASED,
+	// Call the key callback.  lParam bit 30 is the previous key state, so a
+	// key-down with it set is an auto-repeat; the state writes above are
+	// no-ops for it since the key is already down.
+	if(keycode) {
+		uint32_t action = key_down ? ((lParam & (1 << 30)) ? MKFW_REPEAT : MKFW_PRESSED) : MKFW_RELEASED;
+		mkfw_emit_key(state, mkfw_get_time(), keycode, action,
 			(state->keyboard_state[MKFW_KEY_SHIFT] ? MKFW_MOD_SHIFT : 0) |
 			(state->keyboard_state[MKFW_KEY_CTRL] ? MKFW_MOD_CTRL : 0) |
 			(state->keyboard_state[MKFW_KEY_ALT] ? MKFW_MOD_ALT : 0) |
@@ -419,12 +456,15 @@ static LRESULT CALLBACK Win32WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
 		return DefWindowProc(hwnd, uMsg, wParam, lParam);
 	}
 
+	// Merged raw motion goes out ahead of any other input that follows it.
+	if(PLATFORM(state)->coalesced_delta.pending && uMsg != WM_INPUT && uMsg != WM_MOUSEMOVE) {
+		mkfw_delta_flush(state, &PLATFORM(state)->coalesced_delta);
+	}
+
 	switch(uMsg) {
 		case WM_CLOSE:
 			PLATFORM(state)->should_close = 1;
-			if(state->close_callback) {
-				state->close_callback(state);
-			}
+			mkfw_emit_close(state, mkfw_get_time());
 			return 0;
 
 		case WM_DESTROY:
@@ -501,9 +541,7 @@ static LRESULT CALLBACK Win32WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
 			int new_width  = LOWORD(lParam);
 			int new_height = HIWORD(lParam);
 
-			if(state->framebuffer_callback) {
-				state->framebuffer_callback(state, new_width, new_height, PLATFORM(state)->aspect_ratio);
-			}
+			mkfw_emit_framebuffer_size(state, mkfw_get_time(), new_width, new_height, PLATFORM(state)->aspect_ratio);
 
 			if(state->window_state_callback) {
 				uint8_t maximized = (wParam == SIZE_MAXIMIZED) ? 1 : 0;
@@ -604,38 +642,28 @@ static LRESULT CALLBACK Win32WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
 				PLATFORM(state)->high_surrogate = 0;
 			}
 			if(ch == 8 || ch >= 32) {
-				if(state->char_callback) {
-					state->char_callback(state, ch);
-				}
+				mkfw_emit_char(state, mkfw_get_time(), ch);
 			}
 		} break;
 
 		case WM_SETFOCUS: {
 			state->has_focus = 1;
-			if(state->focus_callback) {
-				state->focus_callback(state, 1);
-			}
+			mkfw_emit_focus(state, mkfw_get_time(), 1);
 		} break;
 
 		case WM_KILLFOCUS: {
 			state->has_focus = 0;
-			if(state->focus_callback) {
-				state->focus_callback(state, 0);
-			}
+			mkfw_emit_focus(state, mkfw_get_time(), 0);
 		} break;
 
 		case WM_MOUSEWHEEL: {
 			short delta = GET_WHEEL_DELTA_WPARAM(wParam);
-			if(state->scroll_callback) {
-				state->scroll_callback(state, 0.0, (double)delta / (double)WHEEL_DELTA);
-			}
+			mkfw_emit_scroll(state, mkfw_get_time(), 0.0, (double)delta / (double)WHEEL_DELTA);
 		} break;
 
 		case WM_MOUSEHWHEEL: {
 			short delta = GET_WHEEL_DELTA_WPARAM(wParam);
-			if(state->scroll_callback) {
-				state->scroll_callback(state, (double)delta / (double)WHEEL_DELTA, 0.0);
-			}
+			mkfw_emit_scroll(state, mkfw_get_time(), (double)delta / (double)WHEEL_DELTA, 0.0);
 		} break;
 
 		case WM_MOUSEMOVE: {
@@ -650,29 +678,21 @@ static LRESULT CALLBACK Win32WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
 				TrackMouseEvent(&tme);
 				PLATFORM(state)->mouse_tracked = 1;
 				state->mouse_in_window = 1;
-				if(state->cursor_enter_callback) {
-					state->cursor_enter_callback(state, 1);
-				}
-			}
-			if(state->cursor_pos_callback) {
-				state->cursor_pos_callback(state, state->mouse_x, state->mouse_y);
+				mkfw_emit_cursor_enter(state, mkfw_get_time(), 1);
 			}
+			mkfw_emit_cursor_pos(state, mkfw_get_time(), state->mouse_x, state->mouse_y);
 		} break;
 
 		case WM_MOUSELEAVE: {
 			PLATFORM(state)->mouse_tracked = 0;
 			state->mouse_in_window = 0;
-			if(state->cursor_enter_callback) {
-				state->cursor_enter_callback(state, 0);
-			}
+			mkfw_emit_cursor_enter(state, mkfw_get_time(), 0);
 		} break;
 
 		case WM_LBUTTONDOWN: {
 			SetCapture(hwnd);
 			state->mouse_buttons[MKFW_MOUSE_LEFT] = 1;
-			if(state->mouse_button_callback) {
-				state->mouse_button_callback(state, MKFW_MOUSE_LEFT, MKFW_PRESSED);
-			}
+			mkfw_emit_mouse_button(state, mkfw_get_time(), MKFW_MOUSE_LEFT, MKFW_PRESSED);
 		} break;
 
 		case WM_LBUTTONUP: {
@@ -680,17 +700,13 @@ static LRESULT CALLBACK Win32WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
 			if(!state->mouse_buttons[MKFW_MOUSE_RIGHT] && !state->mouse_buttons[MKFW_MOUSE_MIDDLE]) {
 				ReleaseCapture();
 			}
-			if(state->mouse_button_callback) {
-				state->mouse_button_callback(state, MKFW_MOUSE_LEFT, MKFW_RELEASED);
-			}
+			mkfw_emit_mouse_button(state, mkfw_get_time(), MKFW_MOUSE_LEFT, MKFW_RELEASED);
 		} break;
 
 		case WM_MBUTTONDOWN: {
 			SetCapture(hwnd);
 			state->mouse_buttons[MKFW_MOUSE_MIDDLE] = 1;
-			if(state->mouse_button_callback) {
-				state->mouse_button_callback(state, MKFW_MOUSE_MIDDLE, MKFW_PRESSED);
-			}
+			mkfw_emit_mouse_button(state, mkfw_get_time(), MKFW_MOUSE_MIDDLE, MKFW_PRESSED);
 		} break;
 
 		case WM_MBUTTONUP: {
@@ -698,17 +714,13 @@ static LRESULT CALLBACK Win32WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
 			if(!state->mouse_buttons[MKFW_MOUSE_LEFT] && !state->mouse_buttons[MKFW_MOUSE_RIGHT]) {
 				ReleaseCapture();
 			}
-			if(state->mouse_button_callback) {
-				state->mouse_button_callback(state, MKFW_MOUSE_MIDDLE, MKFW_RELEASED);
-			}
+			mkfw_emit_mouse_button(state, mkfw_get_time(), MKFW_MOUSE_MIDDLE, MKFW_RELEASED);
 		} break;
 
 		case WM_RBUTTONDOWN: {
 			SetCapture(hwnd);
 			state->mouse_buttons[MKFW_MOUSE_RIGHT] = 1;
-			if(state->mouse_button_callback) {
-				state->mouse_button_callback(state, MKFW_MOUSE_RIGHT, MKFW_PRESSED);
-			}
+			mkfw_emit_mouse_button(state, mkfw_get_time(), MKFW_MOUSE_RIGHT, MKFW_PRESSED);
 		} break;
 
 		case WM_RBUTTONUP: {
@@ -716,18 +728,14 @@ static LRESULT CALLBACK Win32WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
 			if(!state->mouse_buttons[MKFW_MOUSE_LEFT] && !state->mouse_buttons[MKFW_MOUSE_MIDDLE]) {
 				ReleaseCapture();
 			}
-			if(state->mouse_button_callback) {
-				state->mouse_button_callback(state, MKFW_MOUSE_RIGHT, MKFW_RELEASED);
-			}
+			mkfw_emit_mouse_button(state, mkfw_get_time(), MKFW_MOUSE_RIGHT, MKFW_RELEASED);
 		} break;
 
 		case WM_XBUTTONDOWN: {
 			SetCapture(hwnd);
 			uint8_t mapped = (GET_XBUTTON_WPARAM(wParam) == XBUTTON1) ? MKFW_MOUSE_EXTRA1 : MKFW_MOUSE_EXTRA2;
 			state->mouse_buttons[mapped] = 1;
-			if(state->mouse_button_callback) {
-				state->mouse_button_callback(state, mapped, MKFW_PRESSED);
-			}
+			mkfw_emit_mouse_button(state, mkfw_get_time(), mapped, MKFW_PRESSED);
 			return TRUE;
 		}
 
@@ -737,9 +745,7 @@ static LRESULT CALLBACK Win32WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
 			if(!state->mouse_buttons[MKFW_MOUSE_LEFT] && !state->mouse_buttons[MKFW_MOUSE_RIGHT] && !state->mouse_buttons[MKFW_MOUSE_MIDDLE]) {
 				ReleaseCapture();
 			}
-			if(state->mouse_button_callback) {
-				state->mouse_button_callback(state, mapped, MKFW_RELEASED);
-			}
+			mkfw_emit_mouse_button(state, mkfw_get_time(), mapped, MKFW_RELEASED);
 			return TRUE;
 		}
 
@@ -766,8 +772,10 @@ static LRESULT CALLBACK Win32WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPA
 					PLATFORM(state)->accumulated_dx += dx * PLATFORM(state)->mouse_sensitivity;
 					PLATFORM(state)->accumulated_dy += dy * PLATFORM(state)->mouse_sensitivity;
 
-					if(state->mouse_move_delta_callback) {
-						state->mouse_move_delta_callback(state, (int)dx, (int)dy);
+					if(state->context->flags & MKFW_INIT_COALESCE_MOTION) {
+						mkfw_delta_add(&PLATFORM(state)->coalesced_delta, mkfw_get_time(), dx, dy);
+					} else {
+						mkfw_emit_mouse_delta(state, mkfw_get_time(), (int)dx, (int)dy);
 					}
 				}
 			}
@@ -950,18 +958,35 @@ MKFW_API uint32_t mkfw_query_max_gl_version(int32_t *major, int32_t *minor) {
 	return result;
 }
 
+// [=]===^=[ win32_context_gl_version ]===========================================================[=]
+static uint32_t win32_context_gl_version(struct mkfw_context *ctx, int32_t *major, int32_t *minor) {
+	struct win32_mkfw_context *wc = CTX_PLATFORM(ctx);
+	if(!wc->gl_probed) {
+		wc->gl_probed = 1;
+		mkfw_query_max_gl_version(&wc->gl_max_major, &wc->gl_max_minor);
+	}
+	if(wc->gl_max_major <= 0) {
+		return 0;
+	}
+	*major = wc->gl_max_major;
+	*minor = wc->gl_max_minor;
+	return 1;
+}
+
 // [=]===^=[ mkfw_init ]==========================================================================[=]
 MKFW_API struct mkfw_context *mkfw_init(struct mkfw_options *opts) {
-	(void)opts;
-
+	struct mkfw_options options;
+	mkfw_options_load(&options, opts);
+	opts = &options;
 	struct mkfw_context *ctx = (struct mkfw_context *)calloc(1, sizeof(struct mkfw_context));
 	if(!ctx) {
 		mkfw_error("mkfw_init: out of memory");
 		return 0;
 	}
 	ctx->platform = calloc(1, sizeof(struct win32_mkfw_context));
-	if(!ctx->platform) {
+	if(!ctx->platform || !mkfw_context_apply_options(ctx, opts)) {
 		mkfw_error("mkfw_init: out of memory");
+		free(ctx->platform);
 		free(ctx);
 		return 0;
 	}
@@ -983,6 +1008,7 @@ MKFW_API struct mkfw_context *mkfw_init(struct mkfw_options *opts) {
 	if(mkfw_win32_perf_freq.QuadPart == 0) {
 		QueryPerformanceFrequency(&mkfw_win32_perf_freq);
 	}
+	uint64_t init_start = mkfw_get_time();
 
 	CTX_PLATFORM(ctx)->hinstance = GetModuleHandle(0);
 
@@ -996,27 +1022,84 @@ MKFW_API struct mkfw_context *mkfw_init(struct mkfw_options *opts) {
 		mkfw_win32_class_registered = 1;
 	}
 
+	uint64_t t = mkfw_get_time();
 	ctx->monitor_count = (uint32_t)mkfw_query_monitors_into(ctx->monitors, MKFW_MAX_MONITORS);
+	ctx->stats.startup.monitors_ns = mkfw_get_time() - t;
 
+	ctx->stats.startup.init_ns = mkfw_get_time() - init_start;
 	return ctx;
 }
 
-// [=]===^=[ mkfw_window_create ]=================================================================[=]
-MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct mkfw_window_options *opts) {
-	if(!ctx) {
-		mkfw_error("mkfw_window_create: ctx is null");
+// [=]===^=[ win32_swap_resolve ]=================================================================[=]
+// Resolve swap control once per context, while a new window's context is
+// current; wglGetProcAddress answers nothing without one.
+static void win32_swap_resolve(struct mkfw_context *ctx, HDC hdc) {
+	struct win32_mkfw_context *wc = CTX_PLATFORM(ctx);
+	if(wc->swap_resolved) {
+		return;
+	}
+	wc->swap_resolved = 1;
+
+	typedef const char *(WINAPI *PFNWGLGETEXTENSIONSSTRINGARB)(HDC);
+	PFNWGLGETEXTENSIONSSTRINGARB wglGetExtensionsStringARB = (PFNWGLGETEXTENSIONSSTRINGARB)(void *)wglGetProcAddress("wglGetExtensionsStringARB");
+	const char *exts = wglGetExtensionsStringARB ? wglGetExtensionsStringARB(hdc) : 0;
+	*(void **)&wc->wglSwapIntervalEXT    = (void *)wglGetProcAddress("wglSwapIntervalEXT");
+	*(void **)&wc->wglGetSwapIntervalEXT = (void *)wglGetProcAddress("wglGetSwapIntervalEXT");
+	if(wc->wglSwapIntervalEXT && wc->wglGetSwapIntervalEXT) {
+		wc->swap_caps = MKFW_SWAP_CAP_INTERVAL;
+		if(exts && strstr(exts, "WGL_EXT_swap_control_tear")) {
+			wc->swap_caps |= MKFW_SWAP_CAP_TEAR;
+		}
+	}
+}
+
+// [=]===^=[ win32_gl_context_has_sync ]==========================================================[=]
+// Whether the current context can use fences: GL 3.2 or ARB_sync.  Core
+// contexts have no GL_EXTENSIONS string; walk glGetStringi instead.
+static uint32_t win32_gl_context_has_sync(void) {
+	typedef const unsigned char *(WINAPI *PFNGLGETSTRINGPROC)(unsigned int);
+	typedef const unsigned char *(WINAPI *PFNGLGETSTRINGIPROC)(unsigned int, unsigned int);
+	typedef void (WINAPI *PFNGLGETINTEGERVPROC)(unsigned int, int *);
+	HMODULE gl_module = GetModuleHandleA("opengl32.dll");
+	PFNGLGETSTRINGPROC pglGetString = gl_module ? (PFNGLGETSTRINGPROC)(void *)GetProcAddress(gl_module, "glGetString") : 0;
+	const char *version = pglGetString ? (const char *)pglGetString(0x1F02) : 0;   // GL_VERSION
+	int32_t major = 0, minor = 0;
+	if(!version || !mkfw_parse_version(version, &major, &minor)) {
 		return 0;
 	}
-	if(ctx->window_count >= MKFW_MAX_WINDOWS) {
-		mkfw_error("mkfw_window_create: context already at MKFW_MAX_WINDOWS (%d)", MKFW_MAX_WINDOWS);
+	if(major > 3 || (major == 3 && minor >= 2)) {
+		return 1;
+	}
+	const char *exts = (const char *)pglGetString(0x1F03);   // GL_EXTENSIONS
+	if(exts) {
+		size_t len = strlen("GL_ARB_sync");
+		for(const char *p = exts; (p = strstr(p, "GL_ARB_sync")); p += len) {
+			if((p == exts || p[-1] == ' ') && (p[len] == ' ' || p[len] == 0)) {
+				return 1;
+			}
+		}
 		return 0;
 	}
-
-	struct mkfw_window_options defaults = {0};
-	if(!opts) {
-		opts = &defaults;
+	PFNGLGETSTRINGIPROC pglGetStringi = (PFNGLGETSTRINGIPROC)(void *)wglGetProcAddress("glGetStringi");
+	PFNGLGETINTEGERVPROC pglGetIntegerv = (PFNGLGETINTEGERVPROC)(void *)GetProcAddress(gl_module, "glGetIntegerv");
+	int count = 0;
+	if(major < 3 || !pglGetStringi || !pglGetIntegerv) {
+		return 0;
+	}
+	pglGetIntegerv(0x821D, &count);   // GL_NUM_EXTENSIONS
+	for(int i = 0; i < count; ++i) {
+		const char *name = (const char *)pglGetStringi(0x1F03, (unsigned int)i);
+		if(name && strcmp(name, "GL_ARB_sync") == 0) {
+			return 1;
+		}
 	}
+	return 0;
+}
 
+// [=]===^=[ win32_window_create ]================================================================[=]
+// Create the native window and its GL context, not in ctx->windows[] and
+// not shown.
+static struct mkfw_window *win32_window_create(struct mkfw_context *ctx, struct mkfw_window_options *opts) {
 	uint32_t graphics_api = opts->graphics_api;
 	if(graphics_api == MKFW_GFX_GLES || graphics_api == MKFW_GFX_VULKAN) {
 		mkfw_error("graphics_api %u not supported (only MKFW_GFX_GL and MKFW_GFX_NONE)", graphics_api);
@@ -1028,7 +1111,7 @@ MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct
 	int32_t gl_major = opts->gl_major;
 	int32_t gl_minor = opts->gl_minor;
 	if(gl_major == 0 && graphics_api == MKFW_GFX_GL) {
-		if(!mkfw_query_max_gl_version(&gl_major, &gl_minor)) {
+		if(!win32_context_gl_version(ctx, &gl_major, &gl_minor)) {
 			mkfw_error("mkfw_window_create: unable to query driver's maximum OpenGL version");
 			return 0;
 		}
@@ -1169,7 +1252,7 @@ MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct
 				PLATFORM(state)->hglrc = modern_ctx;
 			} else {
 				int32_t max_major = 0, max_minor = 0;
-				mkfw_query_max_gl_version(&max_major, &max_minor);
+				win32_context_gl_version(ctx, &max_major, &max_minor);
 				if(max_major > 0) {
 					mkfw_error("OpenGL %d.%d %s Profile not available (driver supports up to %d.%d)",
 						gl_major, gl_minor, gl_profile_name, max_major, max_minor);
@@ -1185,6 +1268,11 @@ MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct
 		}
 	}
 
+	if(PLATFORM(state)->hglrc) {
+		win32_swap_resolve(ctx, PLATFORM(state)->hdc);
+		PLATFORM(state)->has_sync = win32_gl_context_has_sync();
+	}
+
 	PLATFORM(state)->saved_style = style;
 	GetWindowRect(PLATFORM(state)->hwnd, &PLATFORM(state)->saved_rect);
 	mkfw_enable_raw_mouse(state, 1);
@@ -1215,7 +1303,112 @@ MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct
 
 	state->has_focus = 1;
 
-	ctx->windows[ctx->window_count++] = state;
+	PLATFORM(state)->options = *opts;
+	PLATFORM(state)->options.title = 0;
+	PLATFORM(state)->options.x11_class_name = 0;
+
+	return state;
+}
+
+MKFW_API void mkfw_window_set_title(struct mkfw_window *state, const char *title);
+MKFW_API void mkfw_window_set_size(struct mkfw_window *state, int32_t width, int32_t height);
+
+// [=]===^=[ win32_window_pool_take ]=============================================================[=]
+static struct mkfw_window *win32_window_pool_take(struct mkfw_context *ctx, struct mkfw_window_options *opts) {
+	for(uint32_t i = 0; i < ctx->pool_count; ++i) {
+		struct mkfw_window *state = ctx->pool[i];
+		if(mkfw_window_options_compatible(&PLATFORM(state)->options, opts)) {
+			ctx->pool[i] = ctx->pool[--ctx->pool_count];
+			ctx->pool[ctx->pool_count] = 0;
+			return state;
+		}
+	}
+	return 0;
+}
+
+// [=]===^=[ win32_fences_resolve ]===============================================================[=]
+// wglGetProcAddress only answers with a context current, so this waits for
+// the first fenced swap.
+static uint32_t win32_fences_resolve(struct mkfw_context *ctx) {
+	struct win32_mkfw_context *wc = CTX_PLATFORM(ctx);
+	if(!wc->fences_resolved) {
+		wc->fences_resolved = 1;
+		*(void **)&wc->glFenceSync      = (void *)wglGetProcAddress("glFenceSync");
+		*(void **)&wc->glClientWaitSync = (void *)wglGetProcAddress("glClientWaitSync");
+		*(void **)&wc->glDeleteSync     = (void *)wglGetProcAddress("glDeleteSync");
+		if(!wc->glFenceSync || !wc->glClientWaitSync || !wc->glDeleteSync) {
+			wc->glFenceSync = 0;
+		}
+	}
+	return wc->glFenceSync != 0;
+}
+
+// [=]===^=[ win32_frame_fences_clear ]===========================================================[=]
+// Drop every outstanding frame fence; the window's context must be current.
+static void win32_frame_fences_clear(struct mkfw_window *state) {
+	struct win32_mkfw_window *ww = PLATFORM(state);
+	for(uint32_t i = 0; i < MKFW_MAX_FRAMES_IN_FLIGHT; ++i) {
+		if(ww->fences[i]) {
+			CTX_PLATFORM(state->context)->glDeleteSync(ww->fences[i]);
+			ww->fences[i] = 0;
+		}
+	}
+	ww->fence_head = 0;
+}
+
+// [=]===^=[ win32_window_handout ]===============================================================[=]
+// Give a pooled window the size and title of a new request.  The GL
+// context and pixel format already match.
+static void win32_window_handout(struct mkfw_window *state, struct mkfw_window_options *opts) {
+	RECT rect;
+	GetClientRect(PLATFORM(state)->hwnd, &rect);
+	int32_t width  = opts->width  > 0 ? opts->width  : 1280;
+	int32_t height = opts->height > 0 ? opts->height : 720;
+	if(width != rect.right - rect.left || height != rect.bottom - rect.top) {
+		mkfw_window_set_size(state, width, height);
+	}
+	mkfw_window_set_title(state, opts->title ? opts->title : "mkfw");
+
+	PLATFORM(state)->options = *opts;
+	PLATFORM(state)->options.title = 0;
+	PLATFORM(state)->options.x11_class_name = 0;
+	state->has_focus = 1;
+
+	if(PLATFORM(state)->hglrc) {
+		wglMakeCurrent(PLATFORM(state)->hdc, PLATFORM(state)->hglrc);
+		win32_frame_fences_clear(state);
+	}
+}
+
+// [=]===^=[ mkfw_window_create ]=================================================================[=]
+MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct mkfw_window_options *opts) {
+	if(!ctx) {
+		mkfw_error("mkfw_window_create: ctx is null");
+		return 0;
+	}
+	if(!mkfw_context_reserve_window(ctx)) {
+		return 0;
+	}
+
+	struct mkfw_window_options options;
+	mkfw_window_options_load(&options, opts);
+	opts = &options;
+
+	uint64_t start = mkfw_get_time();
+	struct mkfw_window *state = win32_window_pool_take(ctx, opts);
+	if(state) {
+		win32_window_handout(state, opts);
+	} else {
+		state = win32_window_create(ctx, opts);
+		if(!state) {
+			return 0;
+		}
+	}
+	if(!ctx->stats.startup.first_window_ns) {
+		ctx->stats.startup.first_window_ns = mkfw_get_time() - start;
+	}
+
+	mkfw_context_link_window(ctx, state);
 
 	if(!(opts->flags & MKFW_WIN_HIDDEN)) {
 		int show_cmd = SW_SHOW;
@@ -1230,6 +1423,54 @@ MKFW_API struct mkfw_window *mkfw_window_create(struct mkfw_context *ctx, struct
 	return state;
 }
 
+// [=]===^=[ mkfw_window_create_async ]===========================================================[=]
+// Queue a window for creation by mkfw_poll_events and return at once; the
+// pump creates one requested window per call.
+MKFW_API uint32_t mkfw_window_create_async(struct mkfw_context *ctx, struct mkfw_window_options *opts, struct mkfw_window_request *req) {
+	if(!ctx || !req) {
+		mkfw_error("mkfw_window_create_async: ctx or req is null");
+		return 0;
+	}
+	mkfw_window_request_queue(ctx, opts, req);
+	return 1;
+}
+
+// [=]===^=[ win32_window_request_step ]==========================================================[=]
+static void win32_window_request_step(struct mkfw_context *ctx) {
+	struct mkfw_window_request *req = mkfw_window_request_pop(ctx);
+	if(!req) {
+		return;
+	}
+	req->window = mkfw_window_create(ctx, &req->options);
+	req->ready = 1;
+	if(req->callback) {
+		req->callback(req);
+	}
+}
+
+// [=]===^=[ mkfw_window_pool_fill ]==============================================================[=]
+// Create hidden windows for opts ahead of time, up to count in the pool
+// and MKFW_MAX_POOLED_WINDOWS in total.  Returns how many were added.
+MKFW_API uint32_t mkfw_window_pool_fill(struct mkfw_context *ctx, struct mkfw_window_options *opts, uint32_t count) {
+	if(!ctx) {
+		return 0;
+	}
+	struct mkfw_window_options pooled;
+	mkfw_window_options_load(&pooled, opts);
+	pooled.flags |= MKFW_WIN_HIDDEN;
+
+	uint32_t added = 0;
+	while(added < count && ctx->pool_count < MKFW_MAX_POOLED_WINDOWS) {
+		struct mkfw_window *state = win32_window_create(ctx, &pooled);
+		if(!state) {
+			break;
+		}
+		ctx->pool[ctx->pool_count++] = state;
+		++added;
+	}
+	return added;
+}
+
 // [=]===^=[ mkfw_window_set_fullscreen ]====================================================================[=]
 MKFW_API void mkfw_window_set_fullscreen(struct mkfw_window *state, int32_t enable, int32_t monitor_index, struct mkfw_video_mode *mode) {
 	struct mkfw_context *ctx = state->context;
@@ -1303,12 +1544,35 @@ MKFW_API void mkfw_window_set_fullscreen(struct mkfw_window *state, int32_t enab
 	}
 }
 
+// [=]===^=[ mkfw_next_event ]====================================================================[=]
+// Pop the oldest queued input record (MKFW_INIT_EVENT_QUEUE).  Returns 1
+// and fills *out, or 0 when the queue is empty or queued mode is off.
+// Lock-free and safe against a concurrent mkfw_poll_events on another
+// thread; only one thread may consume at a time.
+MKFW_API uint32_t mkfw_next_event(struct mkfw_context *ctx, struct mkfw_event *out) {
+	return mkfw_event_ring_pop(&ctx->event_queue, out);
+}
+
+// [=]===^=[ mkfw_next_raw_event ]================================================================[=]
+// Pop the oldest raw input record (MKFW_INIT_INPUT_THREAD): a
+// MKFW_EVENT_MOUSE_DELTA, MKFW_EVENT_MOUSE_BUTTON or MKFW_EVENT_SCROLL
+// with window == 0.  Returns 1 and fills *out, or 0 when nothing is
+// pending or the input thread is not running.  Never blocks; only one
+// thread may consume at a time.
+MKFW_API uint32_t mkfw_next_raw_event(struct mkfw_context *ctx, struct mkfw_event *out) {
+	return mkfw_event_ring_pop(&ctx->raw_input, out);
+}
+
 // [=]===^=[ mkfw_poll_events ]===================================================================[=]
 MKFW_API void mkfw_poll_events(struct mkfw_context *ctx) {
 	if(!ctx) {
 		return;
 	}
+	win32_window_request_step(ctx);
+
 	MSG msg;
+	uint64_t deadline = ctx->pump_budget_ns ? mkfw_get_time() + ctx->pump_budget_ns : 0;
+	uint32_t handled = 0;
 	while(PeekMessage(&msg, 0, 0, 0, PM_REMOVE)) {
 		if(msg.message == WM_QUIT) {
 			for(uint32_t i = 0; i < ctx->window_count; ++i) {
@@ -1318,6 +1582,14 @@ MKFW_API void mkfw_poll_events(struct mkfw_context *ctx) {
 		}
 		TranslateMessage(&msg);
 		DispatchMessage(&msg);
+		if(mkfw_pump_budget_spent(ctx, ++handled, deadline)) {
+			break;
+		}
+	}
+	if(ctx->flags & MKFW_INIT_COALESCE_MOTION) {
+		for(uint32_t i = 0; i < ctx->window_count; ++i) {
+			mkfw_delta_flush(ctx->windows[i], &PLATFORM(ctx->windows[i])->coalesced_delta);
+		}
 	}
 }
 
@@ -1368,26 +1640,65 @@ MKFW_API void mkfw_window_get_native_handles(struct mkfw_window *state, struct m
 	out->gl_context = (void *)PLATFORM(state)->hglrc;
 }
 
-// [=]===^=[ mkfw_window_set_swap_interval ]==============================================================[=]
-MKFW_API void mkfw_window_set_swap_interval(struct mkfw_window *state, uint32_t interval) {
-	(void)state;
-	typedef BOOL (WINAPI *PFNWGLSWAPINTERVALEXT)(int);
-	PFNWGLSWAPINTERVALEXT wglSwapIntervalEXT = (PFNWGLSWAPINTERVALEXT)(void*)wglGetProcAddress("wglSwapIntervalEXT");
+// [=]===^=[ win32_swap_interval ]================================================================[=]
+// The WGL calls act on the current context; make the window's current for
+// the call if it is not.
+static int32_t win32_swap_interval(struct mkfw_window *state, int32_t set, int32_t interval) {
+	struct win32_mkfw_context *wc = CTX_PLATFORM(state->context);
+	HGLRC prev_ctx = wglGetCurrentContext();
+	HDC prev_dc = wglGetCurrentDC();
+	uint32_t switched = prev_ctx != PLATFORM(state)->hglrc;
+	if(switched) {
+		wglMakeCurrent(PLATFORM(state)->hdc, PLATFORM(state)->hglrc);
+	}
+	int32_t result = set ? wc->wglSwapIntervalEXT(interval) : wc->wglGetSwapIntervalEXT();
+	if(switched) {
+		wglMakeCurrent(prev_dc, prev_ctx);
+	}
+	return result;
+}
 
-	if(wglSwapIntervalEXT) {
-		wglSwapIntervalEXT(interval);
+// [=]===^=[ win32_swap_interval_apply ]==========================================================[=]
+static void win32_swap_interval_apply(struct mkfw_window *state, int32_t interval) {
+	win32_swap_interval(state, 1, interval);
+	PLATFORM(state)->swap_interval_applied = interval;
+}
+
+// [=]===^=[ mkfw_window_set_swap_interval ]==============================================================[=]
+// A negative interval asks for late swaps to tear (EXT_swap_control_tear);
+// without it the interval is used as positive.
+MKFW_API void mkfw_window_set_swap_interval(struct mkfw_window *state, int32_t interval) {
+	if(!state || !PLATFORM(state)->hglrc || !(CTX_PLATFORM(state->context)->swap_caps & MKFW_SWAP_CAP_INTERVAL)) {
+		return;
+	}
+	if(interval < 0 && !(CTX_PLATFORM(state->context)->swap_caps & MKFW_SWAP_CAP_TEAR)) {
+		interval = -interval;
 	}
+	PLATFORM(state)->swap_interval = interval;
+	PLATFORM(state)->swap_interval_known = 1;
+	win32_swap_interval_apply(state, interval);
 }
 
 // [=]===^=[ mkfw_window_get_swap_interval ]==============================================================[=]
+// Negative when late swaps tear.  While mkfw_present_windows runs the
+// window unthrottled this is the interval the caller asked for, not the
+// 0 on the window.
 MKFW_API int32_t mkfw_window_get_swap_interval(struct mkfw_window *state) {
-	(void)state;
-	typedef int (WINAPI *PFNWGLGETSWAPINTERVALEXT)(void);
-	PFNWGLGETSWAPINTERVALEXT wglGetSwapIntervalEXT = (PFNWGLGETSWAPINTERVALEXT)(void *)wglGetProcAddress("wglGetSwapIntervalEXT");
-	if(wglGetSwapIntervalEXT) {
-		return wglGetSwapIntervalEXT();
+	if(!state || !PLATFORM(state)->hglrc || !(CTX_PLATFORM(state->context)->swap_caps & MKFW_SWAP_CAP_INTERVAL)) {
+		return 0;
 	}
-	return 0;
+	if(PLATFORM(state)->swap_interval_known && PLATFORM(state)->swap_interval_applied != PLATFORM(state)->swap_interval) {
+		return PLATFORM(state)->swap_interval;
+	}
+	return win32_swap_interval(state, 0, 0);
+}
+
+// [=]===^=[ mkfw_window_get_swap_caps ]==========================================================[=]
+MKFW_API uint32_t mkfw_window_get_swap_caps(struct mkfw_window *state) {
+	if(!state || !PLATFORM(state)->hglrc) {
+		return 0;
+	}
+	return CTX_PLATFORM(state->context)->swap_caps;
 }
 
 // [=]===^=[ mkfw_window_should_close ]==================================================================[=]
@@ -1400,9 +1711,123 @@ MKFW_API void mkfw_window_set_should_close(struct mkfw_window *state, int32_t va
 	PLATFORM(state)->should_close = value;
 }
 
+// [=]===^=[ win32_window_swap ]==================================================================[=]
+// Frame fences go into the current context, so they are only kept when
+// the window's own context is current.
+static void win32_window_swap(struct mkfw_window *state, uint32_t fence) {
+	PLATFORM(state)->present.submit_ns = mkfw_get_time();
+	SwapBuffers(PLATFORM(state)->hdc);
+
+	// Fence this frame and wait for the one frames_in_flight swaps back.
+	struct win32_mkfw_window *ww = PLATFORM(state);
+	uint32_t frames = ww->options.frames_in_flight;
+	if(fence && frames && ww->has_sync && win32_fences_resolve(state->context)) {
+		struct win32_mkfw_context *wc = CTX_PLATFORM(state->context);
+		frames = frames < MKFW_MAX_FRAMES_IN_FLIGHT ? frames : MKFW_MAX_FRAMES_IN_FLIGHT;
+		void *oldest = ww->fences[ww->fence_head];
+		ww->fences[ww->fence_head] = wc->glFenceSync(0x9117, 0);   // GL_SYNC_GPU_COMMANDS_COMPLETE
+		ww->fence_head = (ww->fence_head + 1) % frames;
+		if(oldest) {
+			wc->glClientWaitSync(oldest, 0x1, 1000000000ULL);       // GL_SYNC_FLUSH_COMMANDS_BIT
+			wc->glDeleteSync(oldest);
+		}
+	}
+
+	struct mkfw_present_stats *ps = &PLATFORM(state)->present;
+	++ps->swaps;
+	mkfw_present_record(ps, mkfw_get_time(), 0, ps->swaps);
+}
+
 // [=]===^=[ mkfw_window_swap_buffers ]==================================================================[=]
 MKFW_API void mkfw_window_swap_buffers(struct mkfw_window *state) {
-	SwapBuffers(PLATFORM(state)->hdc);
+	struct win32_mkfw_window *ww = PLATFORM(state);
+	if(ww->swap_interval_known && ww->swap_interval_applied != ww->swap_interval) {
+		win32_swap_interval_apply(state, ww->swap_interval);
+	}
+	win32_window_swap(state, 1);
+}
+
+// [=]===^=[ mkfw_present_windows ]===============================================================[=]
+// Swap a set of GL windows together; windows == 0 means every window of
+// the context.  Only the last GL window in the set keeps its swap
+// interval, the others swap with interval 0, so the batch waits for one
+// vblank instead of one per window.
+MKFW_API void mkfw_present_windows(struct mkfw_context *ctx, struct mkfw_window **windows, uint32_t count) {
+	if(!ctx) {
+		return;
+	}
+	if(!windows) {
+		windows = ctx->windows;
+		count = ctx->window_count;
+	}
+
+	uint32_t leader = count;
+	for(uint32_t i = count; i > 0; --i) {
+		if(windows[i - 1] && PLATFORM(windows[i - 1])->hglrc) {
+			leader = i - 1;
+			break;
+		}
+	}
+	if(leader == count) {
+		return;
+	}
+
+	uint32_t can_set = CTX_PLATFORM(ctx)->swap_caps & MKFW_SWAP_CAP_INTERVAL;
+	HGLRC current = wglGetCurrentContext();
+	for(uint32_t i = 0; i <= leader; ++i) {
+		struct mkfw_window *state = windows[i];
+		if(!state || !PLATFORM(state)->hglrc) {
+			continue;
+		}
+		struct win32_mkfw_window *ww = PLATFORM(state);
+		if(can_set) {
+			if(!ww->swap_interval_known) {
+				ww->swap_interval = mkfw_window_get_swap_interval(state);
+				ww->swap_interval_applied = ww->swap_interval;
+				ww->swap_interval_known = 1;
+			}
+			int32_t interval = (i == leader) ? ww->swap_interval : 0;
+			if(ww->swap_interval_applied != interval) {
+				win32_swap_interval_apply(state, interval);
+			}
+		}
+		win32_window_swap(state, ww->hglrc == current);
+	}
+}
+
+// [=]===^=[ mkfw_window_set_frames_in_flight ]===================================================[=]
+// Call on the thread that has the window's GL context current.
+MKFW_API void mkfw_window_set_frames_in_flight(struct mkfw_window *state, uint32_t frames) {
+	if(!state || !PLATFORM(state)->hglrc) {
+		return;
+	}
+	win32_frame_fences_clear(state);
+	PLATFORM(state)->options.frames_in_flight = frames;
+}
+
+// [=]===^=[ mkfw_window_get_present_stats ]======================================================[=]
+// WGL has no swap timing extension we can rely on; swaps are timed on the CPU.
+MKFW_API uint32_t mkfw_window_get_present_stats(struct mkfw_window *state, struct mkfw_present_stats *out) {
+	if(!state || !out || !PLATFORM(state)->hglrc) {
+		return 0;
+	}
+	*out = PLATFORM(state)->present;
+	out->source = MKFW_PRESENT_CPU;
+	out->queue_depth = 0;
+	return 1;
+}
+
+// [=]===^=[ mkfw_window_pace_frame ]=============================================================[=]
+// Spin for the last 1 ms of the wait: Sleep can overshoot by a scheduler tick.
+MKFW_API uint64_t mkfw_window_pace_frame(struct mkfw_window *state, struct mkfw_frame_pacer *pacer) {
+	struct mkfw_present_stats ps;
+	if(!pacer || !mkfw_window_get_present_stats(state, &ps)) {
+		return mkfw_get_time();
+	}
+	RECT rect;
+	GetWindowRect(PLATFORM(state)->hwnd, &rect);
+	int32_t hz = mkfw_monitor_refresh_at(state->context, (rect.left + rect.right) / 2, (rect.top + rect.bottom) / 2);
+	return mkfw_pacer_wait(pacer, &ps, hz, 1000000);
 }
 
 // [=]===^=[ mkfw_window_set_size_limits ]========================================================[=]
@@ -1794,7 +2219,9 @@ MKFW_API void mkfw_window_focus(struct mkfw_window *state) {
 
 // [=]===^=[ mkfw_wait_events ]==================================================================[=]
 MKFW_API void mkfw_wait_events(struct mkfw_context *ctx) {
-	WaitMessage();
+	// MWMO_INPUTAVAILABLE also returns for messages a budgeted pump left
+	// queued, which WaitMessage would sleep through.
+	MsgWaitForMultipleObjectsEx(0, 0, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
 	mkfw_poll_events(ctx);
 }
 
@@ -1804,12 +2231,85 @@ MKFW_API void mkfw_wait_events_timeout(struct mkfw_context *ctx, uint64_t nanose
 	mkfw_poll_events(ctx);
 }
 
+// [=]===^=[ win32_window_recycle ]===============================================================[=]
+// Hide the window and put it back in the pool with its input state,
+// callbacks and everything the setters change on the HWND reset, as if
+// freshly created.
+static void win32_window_recycle(struct mkfw_window *state) {
+	struct mkfw_context *ctx = state->context;
+	struct win32_mkfw_window *ww = PLATFORM(state);
+
+	ShowWindow(ww->hwnd, SW_HIDE);
+
+	// Creation styles drop maximized/minimized, decorations, resizability
+	// and opacity (WS_EX_LAYERED) in one go.
+	DWORD ex_style = 0;
+	if(ww->options.flags & MKFW_WIN_FLOATING) {
+		ex_style |= WS_EX_TOPMOST;
+	}
+	if(ww->options.flags & MKFW_WIN_NO_FOCUS) {
+		ex_style |= WS_EX_NOACTIVATE;
+	}
+	SetWindowLong(ww->hwnd, GWL_STYLE, WS_OVERLAPPEDWINDOW);
+	SetWindowLong(ww->hwnd, GWL_EXSTYLE, ex_style);
+	SetWindowPos(ww->hwnd, (ex_style & WS_EX_TOPMOST) ? HWND_TOPMOST : HWND_NOTOPMOST, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE | SWP_FRAMECHANGED);
+	SendMessage(ww->hwnd, WM_SETICON, ICON_BIG, 0);
+	SendMessage(ww->hwnd, WM_SETICON, ICON_SMALL, 0);
+	ww->saved_style = WS_OVERLAPPEDWINDOW;
+	ww->min_width = 0;
+	ww->min_height = 0;
+	ww->max_width = 0;
+	ww->max_height = 0;
+	ww->aspect_num = 0;
+	ww->aspect_den = 0;
+	ww->aspect_ratio_enabled = 0;
+
+	// Back to the WGL default interval; the counters restart from zero.
+	if(ww->swap_interval_known) {
+		win32_swap_interval_apply(state, 1);
+		ww->swap_interval_known = 0;
+	}
+	memset(&ww->present, 0, sizeof(ww->present));
+	if(ww->cursor_locked) {
+		ClipCursor(0);
+	}
+	DragAcceptFiles(ww->hwnd, FALSE);
+	mkfw_context_unlink_window(ctx, state);
+
+	memset(state, 0, sizeof(*state));
+	state->context = ctx;
+	state->platform = ww;
+
+	ww->cursor_locked = 0;
+	ww->cursor_visible = 1;
+	ww->current_cursor = 0;
+	ww->active_custom_cursor = 0;
+	ww->should_close = 0;
+	ww->high_surrogate = 0;
+	ww->mouse_tracked = 0;
+	ww->last_mouse_dx = 0.0;
+	ww->last_mouse_dy = 0.0;
+	ww->accumulated_dx = 0.0;
+	ww->accumulated_dy = 0.0;
+	ww->mouse_sensitivity = 1.0;
+	memset(&ww->coalesced_delta, 0, sizeof(ww->coalesced_delta));
+	ww->options.flags &= ~MKFW_WIN_RECYCLE;
+
+	ctx->pool[ctx->pool_count++] = state;
+}
+
 // [=]===^=[ mkfw_window_destroy ]================================================================[=]
 MKFW_API void mkfw_window_destroy(struct mkfw_window *state) {
 	if(!state) {
 		return;
 	}
 
+	struct mkfw_context *ctx = state->context;
+	if(ctx && (PLATFORM(state)->options.flags & MKFW_WIN_RECYCLE) && !PLATFORM(state)->is_fullscreen && ctx->pool_count < MKFW_MAX_POOLED_WINDOWS) {
+		win32_window_recycle(state);
+		return;
+	}
+
 	if(PLATFORM(state)->cursor_locked) {
 		ClipCursor(0);
 	}
@@ -1832,24 +2332,27 @@ MKFW_API void mkfw_window_destroy(struct mkfw_window *state) {
 	}
 
 	// Unlink from its context's window list
-	struct mkfw_context *ctx = state->context;
 	if(ctx) {
-		for(uint32_t i = 0; i < ctx->window_count; ++i) {
-			if(ctx->windows[i] == state) {
-				for(uint32_t j = i + 1; j < ctx->window_count; ++j) {
-					ctx->windows[j - 1] = ctx->windows[j];
-				}
-				ctx->windows[ctx->window_count - 1] = 0;
-				--ctx->window_count;
-				break;
-			}
-		}
+		mkfw_context_unlink_window(ctx, state);
 	}
 
 	free(state->platform);
 	free(state);
 }
 
+// [=]===^=[ mkfw_window_pool_clear ]=============================================================[=]
+MKFW_API void mkfw_window_pool_clear(struct mkfw_context *ctx) {
+	if(!ctx) {
+		return;
+	}
+	while(ctx->pool_count > 0) {
+		struct mkfw_window *state = ctx->pool[--ctx->pool_count];
+		ctx->pool[ctx->pool_count] = 0;
+		PLATFORM(state)->options.flags &= ~MKFW_WIN_RECYCLE;
+		mkfw_window_destroy(state);
+	}
+}
+
 // [=]===^=[ mkfw_shutdown ]======================================================================[=]
 MKFW_API void mkfw_shutdown(struct mkfw_context *ctx) {
 	if(!ctx) {
@@ -1858,6 +2361,15 @@ MKFW_API void mkfw_shutdown(struct mkfw_context *ctx) {
 	while(ctx->window_count > 0) {
 		mkfw_window_destroy(ctx->windows[ctx->window_count - 1]);
 	}
+	mkfw_window_pool_clear(ctx);
+
+	// Requests never created finish without a window or callback.
+	struct mkfw_window_request *req;
+	while((req = mkfw_window_request_pop(ctx))) {
+		req->ready = 1;
+	}
+	free(ctx->event_queue.events);
+	free(ctx->windows);
 	free(ctx->platform);
 	free(ctx);
 }
@@ -2073,3 +2585,23 @@ MKFW_API void mkfw_window_enable_drop(struct mkfw_window *state, uint8_t enable)
 	DragAcceptFiles(PLATFORM(state)->hwnd, enable ? TRUE : FALSE);
 }
 
+// [=]===^=[ mkfw_begin_batch ]===================================================================[=]
+// Win32 window calls take effect synchronously; there is no request
+// buffer to hold back, so batches only keep the API portable.
+MKFW_API void mkfw_begin_batch(struct mkfw_context *ctx) {
+	(void)ctx;
+}
+
+// [=]===^=[ mkfw_commit_batch ]==================================================================[=]
+MKFW_API void mkfw_commit_batch(struct mkfw_context *ctx) {
+	(void)ctx;
+}
+
+// [=]===^=[ mkfw_window_update_event_mask ]=============================================================[=]
+// Windows has no per-window event selection, and raw input registered
+// without RIDEV_INPUTSINK only reaches the foreground window, so there is
+// nothing to reselect.
+MKFW_API void mkfw_window_update_event_mask(struct mkfw_window *state) {
+	(void)state;
+}
+
@@ -4,10 +4,15 @@
 // Multi-window dispatch test.  Creates two windows on a single
 // mkfw_context, pumps events for a short period, and verifies that
 // the per-window framebuffer callback fires for each window
-// independently.
+// independently, and that a polling window has raw motion selected
+// from creation.  Then hands a pre-created window out of the pool and
+// recycles it back, creates one window asynchronously, and grows the
+// window list past its initial capacity.
 //
 // Pass criterion: exits 0 after both windows have observed at least
-// one framebuffer event, or after a 1-second timeout.
+// one framebuffer event, or after a 1-second timeout, the pooled
+// window is reused, the async window arrives through its callback,
+// and the window list stays consistent through out-of-order destroys.
 
 #include <stdio.h>
 #include <stdint.h>
@@ -17,6 +22,7 @@
 
 static uint32_t fb_events_a;
 static uint32_t fb_events_b;
+static uint32_t async_callbacks;
 
 // [=]===^=[ on_resize_a ]========================================================================^===[=]
 static void on_resize_a(struct mkfw_window *w, int32_t width, int32_t height, float aspect) {
@@ -30,6 +36,12 @@ static void on_resize_b(struct mkfw_window *w, int32_t width, int32_t height, fl
 	++fb_events_b;
 }
 
+// [=]===^=[ on_window_ready ]====================================================================^===[=]
+static void on_window_ready(struct mkfw_window_request *req) {
+	(void)req;
+	++async_callbacks;
+}
+
 // [=]===^=[ on_error ]===========================================================================^===[=]
 static void on_error(const char *message) {
 	fprintf(stderr, "multi_window: mkfw_error: %s\n", message);
@@ -46,7 +58,7 @@ int main(void) {
 	}
 
 	struct mkfw_window_options opts_a = {
-		.width = 320, .height = 240, .title = "mkfw multi A",
+		.width = 320, .height = 240, .title = "mkfw multi A", .flags = MKFW_WIN_POLL_DELTA,
 	};
 	struct mkfw_window_options opts_b = {
 		.width = 320, .height = 240, .title = "mkfw multi B",
@@ -58,6 +70,8 @@ int main(void) {
 		mkfw_shutdown(ctx);
 		return 1;
 	}
+	// MKFW_WIN_POLL_DELTA selects raw motion before the first delta read.
+	uint32_t poll_ok = PLATFORM(a)->delta_polled && (CTX_PLATFORM(ctx)->xi_opcode < 0 || CTX_PLATFORM(ctx)->raw_motion_selected);
 	mkfw_window_set_framebuffer_size_callback(a, on_resize_a);
 	mkfw_window_set_framebuffer_size_callback(b, on_resize_b);
 
@@ -68,14 +82,123 @@ int main(void) {
 		mkfw_sleep(10000000ULL);
 	}
 
+	// Batched present: both windows swap, only the last keeps its
+	// interval on the drawable, the getter still reports what was asked
+	// for, and a plain swap puts the follower's interval back.
+	struct mkfw_window *set[] = { a, b };
+	uint32_t caps = mkfw_window_get_swap_caps(a) & MKFW_SWAP_CAP_INTERVAL;
+	if(caps) {
+		mkfw_window_set_swap_interval(a, 1);
+		mkfw_window_set_swap_interval(b, 1);
+	}
+	mkfw_window_attach_context(a);
+	mkfw_present_windows(ctx, set, 2);
+	struct mkfw_present_stats ps_a = {0}, ps_b = {0};
+	mkfw_window_get_present_stats(a, &ps_a);
+	mkfw_window_get_present_stats(b, &ps_b);
+	uint32_t batch_ok = ps_a.swaps == 1 && ps_b.swaps == 1;
+	if(caps) {
+		batch_ok = batch_ok && PLATFORM(a)->swap_interval_applied == 0 && mkfw_window_get_swap_interval(a) == 1 && mkfw_window_get_swap_interval(b) == 1;
+		mkfw_window_swap_buffers(a);
+		batch_ok = batch_ok && PLATFORM(a)->swap_interval_applied == 1 && mkfw_window_get_swap_interval(a) == 1;
+	}
+	mkfw_window_detach_context(a);
+
 	mkfw_window_destroy(b);
 	mkfw_window_destroy(a);
+
+	// Pool: the pre-created window is handed out, and with
+	// MKFW_WIN_RECYCLE destroy puts it back instead of freeing it.
+	struct mkfw_window_options opts_pool = {
+		.width = 200, .height = 100, .flags = MKFW_WIN_RECYCLE,
+	};
+	uint32_t filled = mkfw_window_pool_fill(ctx, &opts_pool, 1);
+	struct mkfw_window *pooled = ctx->pool[0];
+	opts_pool.width = 240;
+	opts_pool.title = "mkfw multi pooled";
+	struct mkfw_window *p = mkfw_window_create(ctx, &opts_pool);
+	uint32_t reused = filled == 1 && p == pooled && ctx->pool_count == 0;
+	mkfw_window_set_opacity(p, 0.5f);
+	mkfw_window_destroy(p);
+	reused = reused && ctx->pool_count == 1 && ctx->window_count == 0;
+
+	// Recycling resets what the setters changed: no opacity left behind.
+	Atom opacity = XInternAtom(PLATFORM(pooled)->display, "_NET_WM_WINDOW_OPACITY", False);
+	Atom type = None;
+	int format = 0;
+	unsigned long items = 0, remaining = 0;
+	unsigned char *data = 0;
+	XGetWindowProperty(PLATFORM(pooled)->display, PLATFORM(pooled)->window, opacity, 0, 1, False, AnyPropertyType, &type, &format, &items, &remaining, &data);
+	uint32_t reset = type == None;
+	if(data) {
+		XFree(data);
+	}
+	mkfw_window_pool_clear(ctx);
+	reused = reused && ctx->pool_count == 0;
+
+	// Async: the request comes back through the pump.
+	struct mkfw_window_options opts_async = {
+		.width = 320, .height = 240, .title = "mkfw multi async",
+	};
+	struct mkfw_window_request req = { .callback = on_window_ready };
+	uint32_t queued = mkfw_window_create_async(ctx, &opts_async, &req);
+	t0 = mkfw_get_time();
+	while(queued && !req.ready && mkfw_get_time() - t0 < 5000000000ULL) {
+		mkfw_poll_events(ctx);
+		mkfw_sleep(1000000ULL);
+	}
+	uint32_t async_ok = queued && req.ready && req.window && async_callbacks == 1;
+	mkfw_window_destroy(req.window);
+
+	// Registry: grow past the initial 16 slots, then destroy every other
+	// window and check the survivors stay in creation order and still
+	// index themselves correctly.
+	struct mkfw_window_options opts_many = {
+		.width = 32, .height = 32, .graphics_api = MKFW_GFX_NONE, .flags = MKFW_WIN_HIDDEN,
+	};
+	struct mkfw_window *many[40];
+	uint32_t registry_ok = 1;
+	for(uint32_t i = 0; i < 40; ++i) {
+		many[i] = mkfw_window_create(ctx, &opts_many);
+		registry_ok = registry_ok && many[i];
+	}
+	for(uint32_t i = 0; i < 40 && registry_ok; i += 2) {
+		mkfw_window_destroy(many[i]);
+	}
+	registry_ok = registry_ok && ctx->window_count == 20;
+	for(uint32_t i = 0; i < ctx->window_count && registry_ok; ++i) {
+		registry_ok = ctx->windows[i] == many[i * 2 + 1] && ctx->windows[i]->context_index == i;
+	}
 	mkfw_shutdown(ctx);
 
 	if(fb_events_a == 0 || fb_events_b == 0) {
 		fprintf(stderr, "multi_window: FAIL events a=%u b=%u\n", fb_events_a, fb_events_b);
 		return 1;
 	}
+	if(!poll_ok) {
+		fprintf(stderr, "multi_window: FAIL raw motion not selected for a polling window\n");
+		return 1;
+	}
+	if(!batch_ok) {
+		fprintf(stderr, "multi_window: FAIL batched present\n");
+		return 1;
+	}
+	if(!reset) {
+		fprintf(stderr, "multi_window: FAIL recycled window kept its opacity\n");
+		return 1;
+	}
+	if(!reused) {
+		fprintf(stderr, "multi_window: FAIL pooled window not reused\n");
+		return 1;
+	}
+	if(!async_ok) {
+		fprintf(stderr, "multi_window: FAIL async window not created\n");
+		return 1;
+	}
+	if(!registry_ok) {
+		fprintf(stderr, "multi_window: FAIL window list inconsistent after growth\n");
+		return 1;
+	}
 	printf("multi_window: ok (a=%u events, b=%u events)\n", fb_events_a, fb_events_b);
 	return 0;
 }
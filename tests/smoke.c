@@ -76,6 +76,57 @@ int main(void) {
 		mkfw_sleep(10000000ULL);
 	}
 
+	// --- Cached getters --------------------------------------------
+	int32_t fb_w = 0, fb_h = 0, cx, cy;
+	mkfw_window_get_framebuffer_size(win, &fb_w, &fb_h);
+	EXPECT(fb_w == 640 && fb_h == 360, "framebuffer size does not match the requested size");
+	mkfw_window_get_cursor_position(win, &cx, &cy);
+	mkfw_window_get_framebuffer_size(win, &fb_w, &fb_h);
+	mkfw_poll_events(ctx);
+	EXPECT(ctx->stats.round_trips_last_frame == 0, "idle frame made synchronous round trips");
+
+	// --- Batched updates -------------------------------------------
+	uint64_t rt = ctx->stats.round_trips;
+	mkfw_begin_batch(ctx);
+	mkfw_window_set_title(win, "mkfw smoke (batched)");
+	mkfw_window_set_opacity(win, 1.0f);
+	mkfw_window_show(win);
+	EXPECT(ctx->stats.round_trips == rt, "setters inside a batch waited on the server");
+	mkfw_commit_batch(ctx);
+
+	// --- Swap interval ---------------------------------------------
+	if(mkfw_window_get_swap_caps(win) & MKFW_SWAP_CAP_INTERVAL) {
+		mkfw_window_set_swap_interval(win, 0);
+		EXPECT(mkfw_window_get_swap_interval(win) == 0, "swap interval did not apply to the window");
+	}
+
+	// --- Present stats / frames in flight --------------------------
+	mkfw_window_set_frames_in_flight(win, 1);
+	for(uint32_t i = 0; i < 4; ++i) {
+		mkfw_window_swap_buffers(win);
+	}
+	mkfw_window_set_frames_in_flight(win, 0);
+	mkfw_poll_events(ctx);
+	struct mkfw_present_stats ps = {0};
+	EXPECT(mkfw_window_get_present_stats(win, &ps), "mkfw_window_get_present_stats failed on a GL window");
+	EXPECT(ps.swaps == 4 && ps.sbc <= ps.swaps, "present stats do not count the swaps");
+
+	// Options from an older header end at x11_class_name: version 0 must
+	// not read frames_in_flight.
+	struct mkfw_window_options old_opts = { .frames_in_flight = 2 }, loaded;
+	mkfw_window_options_load(&loaded, &old_opts);
+	EXPECT(loaded.frames_in_flight == 0, "frames_in_flight read from a version 0 options struct");
+	old_opts.version = MKFW_WINDOW_OPTIONS_VERSION;
+	mkfw_window_options_load(&loaded, &old_opts);
+	EXPECT(loaded.frames_in_flight == 2, "frames_in_flight ignored with the current options version");
+
+	// --- Frame pacing ----------------------------------------------
+	struct mkfw_frame_pacer pacer = { .refresh_ns = 2000000 };
+	uint64_t pace_start = mkfw_get_time();
+	uint64_t vblank = mkfw_window_pace_frame(win, &pacer);
+	EXPECT(vblank >= pace_start && pacer.vblank_ns == vblank, "pacer aimed at a vblank in the past");
+	EXPECT(mkfw_get_time() - pace_start < 100000000ULL, "pacer waited far longer than one period");
+
 	// --- Native handles --------------------------------------------
 	struct mkfw_native_handles nh = {0};
 	mkfw_window_get_native_handles(win, &nh);
@@ -86,6 +137,95 @@ int main(void) {
 	mkfw_clear_last_error();
 	EXPECT(mkfw_get_last_error() == 0, "last-error should be clear");
 
+	// --- Queued input ----------------------------------------------
+	struct mkfw_options qopts = { .version = MKFW_OPTIONS_VERSION, .flags = MKFW_INIT_EVENT_QUEUE, .event_queue_capacity = 100 };
+	struct mkfw_context *qctx = mkfw_init(&qopts);
+	EXPECT(qctx != 0, "mkfw_init with MKFW_INIT_EVENT_QUEUE failed");
+	if(qctx) {
+		EXPECT(qctx->event_queue.mask == 127, "event queue capacity not rounded to a power of two");
+		struct mkfw_window *qwin = mkfw_window_create(qctx, &wopts);
+		EXPECT(qwin != 0, "mkfw_window_create on queued context failed");
+		if(qwin) {
+			mkfw_poll_events(qctx);
+			struct mkfw_event ev;
+			while(mkfw_next_event(qctx, &ev)) {
+				EXPECT(ev.window == qwin, "queued event for unknown window");
+				EXPECT(ev.type != MKFW_EVENT_NONE, "queued event without a type");
+			}
+			mkfw_window_destroy(qwin);
+		}
+		mkfw_shutdown(qctx);
+	}
+
+	// --- Motion coalescing / pump budget ---------------------------
+	struct mkfw_delta_accumulator acc = {0};
+	int32_t adx = 0, ady = 0;
+	mkfw_delta_add(&acc, 1, 0.75, -0.75);
+	mkfw_delta_add(&acc, 2, 0.75, -0.75);
+	EXPECT(mkfw_delta_take(&acc, &adx, &ady) && adx == 1 && ady == -1, "coalesced delta lost whole units");
+	mkfw_delta_add(&acc, 3, 0.5, -0.5);
+	EXPECT(mkfw_delta_take(&acc, &adx, &ady) && adx == 1 && ady == -1, "coalesced delta dropped the carried fraction");
+
+	struct mkfw_options copts = { .version = MKFW_OPTIONS_VERSION, .flags = MKFW_INIT_COALESCE_MOTION | MKFW_INIT_EVENT_QUEUE, .pump_budget_events = 1 };
+	struct mkfw_context *cctx = mkfw_init(&copts);
+	EXPECT(cctx != 0, "mkfw_init with MKFW_INIT_COALESCE_MOTION failed");
+	if(cctx) {
+		EXPECT(cctx->pump_budget_events == 1, "pump budget not taken from mkfw_options");
+		struct mkfw_window *cwin = mkfw_window_create(cctx, &wopts);
+		EXPECT(cwin != 0, "mkfw_window_create on coalescing context failed");
+		if(cwin) {
+			// Four property changes are queued by the XSync; a one-event
+			// budget dispatches one of them and leaves the rest queued.
+			Display *dpy = PLATFORM(cwin)->display;
+			Atom prop = XInternAtom(dpy, "MKFW_SMOKE", False);
+			for(long i = 0; i < 4; ++i) {
+				XChangeProperty(dpy, PLATFORM(cwin)->window, prop, XA_CARDINAL, 32, PropModeReplace, (unsigned char *)&i, 1);
+			}
+			XSync(dpy, False);
+			int32_t before = XEventsQueued(dpy, QueuedAlready);
+			mkfw_poll_events(cctx);
+			EXPECT(before >= 4 && XEventsQueued(dpy, QueuedAlready) >= before - 1, "budget-limited pump did not stop after one event");
+			mkfw_set_pump_budget(cctx, 0, 0);
+			mkfw_poll_events(cctx);
+			EXPECT(XEventsQueued(dpy, QueuedAlready) == 0, "unlimited pump left events queued");
+
+			// Raw motion read in one pump comes out as a single delta
+			// carrying the whole units; the fraction waits for the next.
+			struct mkfw_event ev;
+			while(mkfw_next_event(cctx, &ev)) {
+			}
+			mkfw_delta_add(&PLATFORM(cwin)->coalesced_delta, 1, 0.75, -0.75);
+			mkfw_delta_add(&PLATFORM(cwin)->coalesced_delta, 2, 0.75, -0.75);
+			mkfw_poll_events(cctx);
+			uint32_t deltas = 0;
+			while(mkfw_next_event(cctx, &ev)) {
+				if(ev.type == MKFW_EVENT_MOUSE_DELTA) {
+					++deltas;
+					EXPECT(ev.delta.dx == 1 && ev.delta.dy == -1 && ev.time == 2, "coalesced delta has the wrong total or time");
+				}
+			}
+			EXPECT(deltas == 1, "pump did not emit exactly one coalesced delta");
+			mkfw_poll_events(cctx);
+			while(mkfw_next_event(cctx, &ev)) {
+				EXPECT(ev.type != MKFW_EVENT_MOUSE_DELTA, "leftover fraction emitted without new motion");
+			}
+		}
+		mkfw_shutdown(cctx);
+	}
+
+	// --- Raw input thread ------------------------------------------
+	struct mkfw_options ropts = { .version = MKFW_OPTIONS_VERSION, .flags = MKFW_INIT_INPUT_THREAD };
+	struct mkfw_context *rctx = mkfw_init(&ropts);
+	EXPECT(rctx != 0, "mkfw_init with MKFW_INIT_INPUT_THREAD failed");
+	if(rctx) {
+		mkfw_sleep(10000000ULL);
+		struct mkfw_event ev;
+		while(mkfw_next_raw_event(rctx, &ev)) {
+			EXPECT(ev.window == 0, "raw input record tied to a window");
+		}
+		mkfw_shutdown(rctx);   // must stop and join the thread
+	}
+
 	// --- Audio -----------------------------------------------------
 	struct mkfw_audio_options aopts = {0};
 	if(mkfw_audio_init(&aopts)) {